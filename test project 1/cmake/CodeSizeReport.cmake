@@ -0,0 +1,97 @@
+# Reports the size of the code that ctaeb instantiates in a binary, grouped by
+# expression type. Run in script mode:
+#
+#   cmake -DNM=<nm> -DFILE=<binary or object> -P CodeSizeReport.cmake
+#
+# Every function whose demangled name mentions `ctaeb::Compound` is attributed
+# to the first compound type in its name: that's the class of
+# `Compound::operator()`, the tuple of `Invoker::operator()`, or the argument
+# of `operator<<`. Structurally identical sub-expressions of the same type
+# are counted once, which is what `ctaeb::canonical` is for.
+
+if (NOT NM OR NOT FILE)
+    message(FATAL_ERROR "usage: cmake -DNM=<nm> -DFILE=<file> -P ${CMAKE_CURRENT_LIST_FILE}")
+endif()
+
+execute_process(
+        COMMAND ${NM} -C --print-size --size-sort ${FILE}
+        OUTPUT_VARIABLE symbols
+        RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${FILE}")
+endif()
+
+# Returns the type `ctaeb::Compound<...>` that starts at `start` in `name`.
+function(compound_type name start out_var)
+    string(LENGTH "${name}" length)
+    set(depth 0)
+    set(i ${start})
+    while (i LESS length)
+        string(SUBSTRING "${name}" ${i} 1 c)
+        if (c STREQUAL "<")
+            math(EXPR depth "${depth} + 1")
+        elseif (c STREQUAL ">")
+            math(EXPR depth "${depth} - 1")
+            if (depth EQUAL 0)
+                break()
+            endif()
+        endif()
+        math(EXPR i "${i} + 1")
+    endwhile()
+    math(EXPR count "${i} - ${start} + 1")
+    string(SUBSTRING "${name}" ${start} ${count} type)
+    set(${out_var} "${type}" PARENT_SCOPE)
+endfunction()
+
+# `;` and `[`/`]` would confuse list operations on the demangled names
+string(REPLACE ";" "" symbols "${symbols}")
+string(REPLACE "[" "(" symbols "${symbols}")
+string(REPLACE "]" ")" symbols "${symbols}")
+string(REPLACE "\n" ";" symbols "${symbols}")
+
+set(types "")
+set(total 0)
+foreach (line IN LISTS symbols)
+    # <address> <size> <kind> <name>; only code symbols
+    if (NOT line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tTwW] (.*)$")
+        continue()
+    endif()
+    set(size_hex ${CMAKE_MATCH_1})
+    set(name "${CMAKE_MATCH_2}")
+    string(FIND "${name}" "ctaeb::Compound<" start)
+    if (start EQUAL -1)
+        continue()
+    endif()
+    math(EXPR size "0x${size_hex}")
+    math(EXPR total "${total} + ${size}")
+
+    compound_type("${name}" ${start} type)
+    string(MD5 key "${type}")
+    if (NOT DEFINED size_${key})
+        list(APPEND types ${key})
+        set(type_${key} "${type}")
+        set(size_${key} 0)
+        set(functions_${key} 0)
+    endif()
+    math(EXPR size_${key} "${size_${key}} + ${size}")
+    math(EXPR functions_${key} "${functions_${key}} + 1")
+endforeach()
+
+# sort by size, the largest first
+set(lines "")
+foreach (key IN LISTS types)
+    string(LENGTH "${size_${key}}" digits)
+    math(EXPR digits "12 - ${digits}")
+    string(REPEAT "0" ${digits} padding)
+    list(APPEND lines "${padding}${size_${key}} ${key}")
+endforeach()
+list(SORT lines)
+list(REVERSE lines)
+
+message("bytes\tfunctions\texpression")
+foreach (line IN LISTS lines)
+    string(REGEX REPLACE "^[0-9]+ " "" key "${line}")
+    message("${size_${key}}\t${functions_${key}}\t${type_${key}}")
+endforeach()
+list(LENGTH types count)
+message("${total} bytes in ${count} expression types")
@@ -0,0 +1,36 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the class `Adaptive`
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    // `x >= 0` is almost always true, `y == 3` almost always false
+    auto filter = adaptive(x >= 0 && x != y && y == 3);
+
+    int passed = 0;
+    for (int i = 0; i < 100000; ++i) {
+        passed += filter(i, i % 100);
+    }
+
+    // prints:
+    // passed: 999
+    // first: 2
+    std::cout << "passed: " << passed << std::endl;
+    std::cout << "first: " << filter.order()[0] << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,45 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the bitwise operators
+ */
+
+//! [full]
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> h("h");
+
+    // prints:
+    // h % 8 | h << 3
+    std::cout << (h % 8u | h << 3u) << std::endl;
+
+    // one round of xorshift, evaluated over a column of values; the loop
+    // vectorizes like a hand-written one
+    auto step1 = h ^ (h << 13u);
+    auto step2 = step1 ^ (step1 >> 17u);
+    auto bucket = (step2 ^ (step2 << 5u)) & 7u;
+    std::vector<std::uint32_t> keys = {1, 2, 3, 4};
+    std::vector<std::uint32_t> buckets(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        buckets[i] = bucket(keys[i]);
+    }
+
+    // prints:
+    // 1 2 3 4
+    for (std::uint32_t value : buckets) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+//! [full]
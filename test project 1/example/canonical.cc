@@ -0,0 +1,50 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the functions `canonical` and `normalize`
+ */
+
+//! [full]
+#include <iostream>
+#include <type_traits>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    // `x + 1` refers to `x`, while `Variable<1>() + 1` owns its variable,
+    // thus the two sub-expressions have different types
+    auto e = (x + 1) * (Variable<1>() + 1) == y;
+
+    // both sub-expressions have the type `Compound<std::plus, Variable<1>,
+    // Constant<int>>` and share its instantiations
+    auto c = canonical(e);
+    using Sum = Compound<std::plus, Variable<1>, Constant<int>>;
+    static_assert(std::is_same<decltype(c),
+        Compound<std::equal_to,
+                 Compound<std::multiplies, Sum, Sum>,
+                 Variable<2>>>::value, "");
+
+    // prints:
+    // x + 1 * _1 + 1 == y: 1
+    std::cout << c << ": " << c(2, 9) << std::endl;
+
+    // the operands of `+`, `*`, `==` are put in the same order, thus
+    // the two expressions below have the same type
+    auto n1 = normalize(y * 2 == x + y);
+    auto n2 = normalize(x + y == 2 * y);
+    static_assert(std::is_same<decltype(n1), decltype(n2)>::value, "");
+
+    // prints:
+    // y * 2 == x + y: 1
+    std::cout << n2 << ": " << n2(3, 3) << std::endl;
+    return 0;
+}
+//! [full]
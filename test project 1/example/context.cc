@@ -0,0 +1,71 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates evaluation with a `Context`
+ */
+
+//! [full]
+#include <array>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+using namespace std::literals;
+
+/**
+ * Concatenation of two strings; the result is allocated from the evaluation
+ * context if there is one.
+ */
+template<typename T = void>
+struct concatenate {
+    template<typename S1, typename S2>
+    std::pmr::string operator()(std::pmr::memory_resource *resource,
+                                const S1 &s1, const S2 &s2) const {
+        std::pmr::string result(resource);
+        result.reserve(s1.size() + s2.size());
+        result.append(s1.begin(), s1.end());
+        result.append(s2.begin(), s2.end());
+        return result;
+    }
+
+    template<typename S1, typename S2>
+    std::pmr::string operator()(const S1 &s1, const S2 &s2) const {
+        return (*this)(std::pmr::get_default_resource(), s1, s2);
+    }
+};
+
+int main() {
+    Variable<1> first("first");
+    Variable<2> last("last");
+    Variable<3> full("full");
+
+    auto join = [](auto &&x, auto &&y) {
+        return Compound<concatenate, std::decay_t<decltype(x)>,
+                        std::decay_t<decltype(y)>>(x, y);
+    };
+    auto invariant = join(join(first, Constant<std::string_view>(" ")), last) == full;
+
+    std::array<char, 1024> buffer;
+    Context context(buffer.data(), buffer.size());
+    int valid = 0;
+    for (int i = 0; i < 3; ++i) {
+        // no memory is allocated from the heap
+        valid += invariant(context, "Alexander"sv, "Hamilton-Smith"sv,
+                           "Alexander Hamilton-Smith"sv);
+        context.release();
+    }
+
+    // prints:
+    // 3 1
+    std::cout << valid << " "
+              << invariant("A"sv, "B"sv, "A B"sv) << std::endl;
+    return 0;
+}
+//! [full]
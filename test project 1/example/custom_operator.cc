@@ -19,8 +19,8 @@ using namespace ctaeb;
 template <typename U = void>
 struct XOR {
     template <typename T>
-    constexpr auto operator()(T &&s1, T &&s2) const -> std::decay_t<T> {
-        return std::forward<T>(s1) ^ std::forward<T>(s2);
+    constexpr bool operator()(T &&s1, T &&s2) const {
+        return !std::forward<T>(s1) != !std::forward<T>(s2);
     }
 
     //constexpr static bool prefixed = true;
@@ -28,13 +28,14 @@ struct XOR {
 
 namespace ctaeb { namespace print {
 template<>
-std::string to_string<XOR>() {
-    return "^";
+inline std::string to_string<XOR>() {
+    return "xor";
 }
 } }
 
+// `^` is the built-in bitwise xor
 template<typename E1, typename E2, typename = Expressions<E1, E2>>
-auto operator ^(E1 &&x, E2 &&y) -> Compound<XOR, E1, E2> {
+auto logical_xor(E1 &&x, E2 &&y) -> Compound<XOR, E1, E2> {
     return Compound<XOR, E1, E2>(x, y);
 }
 
@@ -42,7 +43,7 @@ int main() {
     Variable<1> _1("x");
     Variable<2> _2("y");
 
-    auto x = _1 ^ _2;
+    auto x = logical_xor(_1, _2);
     std::cout << x << std::endl;
     std::cout << x(1, 3) << std::endl;
 
@@ -10,6 +10,7 @@
 
 //! [full]
 #include <iostream>
+#include <tuple>
 #include <ctaeb/ctaeb.h>
 
 using namespace ctaeb;
@@ -44,6 +45,11 @@ int main() {
     std::cout << sum2(10, -5) << std::endl;
 //! [evaluation]
 
+//! [apply]
+    std::tuple<int, int> values(10, -5);
+    std::cout << sum2.apply(values) << std::endl;
+//! [apply]
+
     auto x = _1 + 1;
     auto y = 1 + _1;
 
@@ -0,0 +1,29 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates evaluation of an expression that is instantiated in
+ * another translation unit; see also `extern_evaluation_instances.cc`.
+ */
+
+//! [full]
+#include <iostream>
+#include "extern_evaluation.h"
+
+using namespace ctaeb;
+
+int main() {
+    SizeInvariant invariant = size_invariant();
+
+    // prints:
+    // size_after == size_before + 1: 1
+    // only a call to `Evaluation<SizeInvariant, bool(int, int)>::call` is
+    // emitted here
+    std::cout << invariant << ": "
+              << evaluate<bool(int, int)>(invariant, 2, 3) << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,29 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Invariants shared by the translation units of the
+ * `extern_evaluation.cc` example.
+ */
+
+#ifndef CTAEB_EXAMPLE_EXTERN_EVALUATION_H
+#define CTAEB_EXAMPLE_EXTERN_EVALUATION_H
+
+//! [declaration]
+#include <ctaeb/ctaeb.h>
+
+inline auto size_invariant() {
+    return ctaeb::Variable<2>("size_after") ==
+           ctaeb::Variable<1>("size_before") + 1;
+}
+
+using SizeInvariant = decltype(size_invariant());
+
+// instantiated in extern_evaluation_instances.cc
+CTAEB_EXTERN_EVALUATION(bool(int, int), SizeInvariant);
+//! [declaration]
+
+#endif //CTAEB_EXAMPLE_EXTERN_EVALUATION_H
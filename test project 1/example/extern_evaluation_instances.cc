@@ -0,0 +1,16 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief The only translation unit of the `extern_evaluation.cc` example
+ * that instantiates evaluation of `SizeInvariant`.
+ */
+
+//! [instantiation]
+#include "extern_evaluation.h"
+
+CTAEB_INSTANTIATE_EVALUATION(bool(int, int), SizeInvariant);
+//! [instantiation]
@@ -0,0 +1,40 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the functions `filter` and `filter_bitmap`
+ */
+
+//! [full]
+#include <iostream>
+#include <vector>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    std::vector<int> xs = {1, 7, 3, 4, 0, 9};
+    std::vector<int> ys = {0, 1, 2, 0, 5, 5};
+
+    // `y != 0` is evaluated only for the rows 0, 2, 3, and 4
+    auto predicate = x < 5 && y != 0;
+
+    // prints:
+    // 2 4
+    for (std::size_t row : filter(predicate, xs, ys)) {
+        std::cout << row << " ";
+    }
+    std::cout << std::endl;
+
+    // prints:
+    // 14
+    std::cout << std::hex << filter_bitmap(predicate, xs, ys)[0] << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,52 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of `to_function_pointer`
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+// a C API that takes a callback with a context pointer
+extern "C" int fold(const int *values, int size, int (*fn)(void *, int, int), void *ctx) {
+    int result = values[0];
+    for (int i = 1; i < size; ++i) {
+        result = fn(ctx, result, values[i]);
+    }
+    return result;
+}
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    // expressions of variables become plain function pointers
+    int (*table[])(int, int) = {
+        to_function_pointer<int(int, int)>(x + y),
+        to_function_pointer<int(int, int)>(x * y),
+        to_function_pointer<int(int, int)>(select(x < y, y, x))
+    };
+
+    // prints:
+    // 10 21 7
+    std::cout << table[0](3, 7) << " " << table[1](3, 7) << " "
+              << table[2](3, 7) << std::endl;
+
+    // an expression with constants becomes a function and a context pointer
+    auto digits = x * 10 + y;
+    auto fn = to_function_pointer<int(int, int)>(digits);
+    const int values[] = {1, 2, 3, 4};
+
+    // prints:
+    // 1234 56
+    std::cout << fold(values, 4, fn.fn, fn.ctx) << " " << fn(5, 6) << std::endl;
+    return 0;
+}
+//! [full]
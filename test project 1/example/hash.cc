@@ -0,0 +1,45 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the functions `hash` and `structurally_equal`
+ */
+
+//! [full]
+#include <iostream>
+#include <unordered_set>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    auto e1 = x + 1 == y;
+    auto e2 = Variable<1>("a") + 1 == Variable<2>("b");
+    auto e3 = x + 2 == y;
+
+    // the structure is compared at compile time, the constants at runtime
+    static_assert(structure_hash_v<decltype(e1)> == structure_hash_v<decltype(e2)>, "");
+
+    // prints:
+    // 1 0
+    std::cout << structurally_equal(e1, e2) << " "
+              << structurally_equal(e1, e3) << std::endl;
+
+    // deduplication of expressions of the same canonical type
+    std::unordered_set<canonical_t<decltype(e1)>, ExpressionHash, StructurallyEqual> unique;
+    unique.insert(canonical(e1));
+    unique.insert(canonical(e2));
+    unique.insert(canonical(e3));
+
+    // prints:
+    // 2
+    std::cout << unique.size() << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,37 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates evaluation counters; built with `CTAEB_INSTRUMENTATION`
+ * defined.
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    auto check = y != 0 && 10 / y < x;
+
+    for (int i = 0; i < 100; ++i) {
+        check(i, i % 4);
+    }
+
+    // prints something like:
+    // calls   short-circuits  cycles  expression
+    // 100     25              41200   y != 0 && 10 / y < x
+    // 100     0               3400      y != 0
+    // 75      0               9100      10 / y < x
+    // 75      0               4100        10 / y
+    instrumentation::report(std::cout, check);
+    return 0;
+}
+//! [full]
@@ -0,0 +1,108 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates how to implement a lazy operation
+ */
+
+//! [full]
+#include <iostream>
+#include <optional>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+/**
+ * The first of two optional values that is present; the second one is not
+ * evaluated if the first one is present.
+ */
+template<typename T = void>
+struct coalesce {
+    static constexpr bool prefixed = true;
+    static constexpr bool lazy = true;
+
+    template<typename F1, typename F2>
+    auto operator()(const F1 &value1, const F2 &value2) const {
+        auto value = value1();
+        return value ? value : value2();
+    }
+};
+
+/**
+ * Division that yields zero if the divisor is zero; the dividend is not
+ * evaluated in this case.
+ */
+template<typename T = void>
+struct guarded_divides {
+    static constexpr bool lazy = true;
+
+    template<typename F1, typename F2>
+    auto operator()(const F1 &dividend, const F2 &divisor) const {
+        auto value = divisor();
+        return value == 0 ? decltype(dividend() / value)(0) : dividend() / value;
+    }
+};
+
+int lookups = 0;
+
+/**
+ * Looks up a value that's expensive to compute.
+ */
+template<typename T = void>
+struct lookup {
+    static constexpr bool prefixed = true;
+
+    template<typename K>
+    std::optional<int> operator()(const K &key) const {
+        ++lookups;
+        return key > 0 ? std::optional<int>(key * 10) : std::nullopt;
+    }
+};
+
+namespace ctaeb { namespace print {
+template<>
+inline std::string to_string<::coalesce>() {
+    return "coalesce";
+}
+
+template<>
+inline std::string to_string<::lookup>() {
+    return "lookup";
+}
+
+template<>
+inline std::string to_string<::guarded_divides>() {
+    return "/?";
+}
+} }
+
+int main() {
+    Variable<1> cached("cached");
+    Variable<2> key("key");
+    Variable<3> x("x");
+    Variable<4> y("y");
+
+    auto value = Compound<coalesce, Variable<1>, Compound<lookup, Variable<2>>>(
+        cached, Compound<lookup, Variable<2>>(key));
+    auto ratio = Compound<guarded_divides, Variable<3>, Variable<4>>(x, y);
+
+    // prints:
+    // coalesce(cached, lookup(key))
+    // x /? y
+    std::cout << value << std::endl << ratio << std::endl;
+
+    // prints:
+    // 7 30 1
+    std::optional<int> hit(7), miss;
+    std::cout << *value(hit, 3, 0, 0) << " "
+              << *value(miss, 3, 0, 0) << " " << lookups << std::endl;
+
+    // prints:
+    // 2 0
+    std::cout << ratio(0, 0, 10, 5) << " " << ratio(0, 0, 10, 0) << std::endl;
+    return 0;
+}
+//! [full]
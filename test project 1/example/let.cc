@@ -0,0 +1,82 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of `let`
+ */
+
+//! [full]
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+static int unions = 0;
+
+/**
+ * The union of two sets.
+ */
+template<typename T = void>
+struct set_union {
+    template<typename Set>
+    Set operator()(const Set &set1, const Set &set2) const {
+        ++unions;
+        Set result;
+        std::set_union(set1.begin(), set1.end(), set2.begin(), set2.end(),
+                       std::inserter(result, result.end()));
+        return result;
+    }
+
+    constexpr static bool prefixed = true;
+};
+
+/**
+ * Tells whether the first set includes the second one.
+ */
+template<typename T = void>
+struct includes {
+    template<typename Set>
+    bool operator()(const Set &set1, const Set &set2) const {
+        return std::includes(set1.begin(), set1.end(), set2.begin(), set2.end());
+    }
+
+    constexpr static bool prefixed = true;
+};
+
+namespace ctaeb { namespace print {
+template<>
+inline std::string to_string<set_union>() {
+    return "union";
+}
+
+template<>
+inline std::string to_string<includes>() {
+    return "includes";
+}
+} }
+
+int main() {
+    Variable<1> a("a");
+    Variable<2> b("b");
+    Local<1> all("all");
+
+    auto merged = Compound<set_union, Variable<1> &, Variable<2> &>(a, b);
+    auto contains_both = Compound<includes, Local<1> &, Variable<1> &>(all, a) &&
+                         Compound<includes, Local<1> &, Variable<2> &>(all, b);
+    auto check = let(all = merged, contains_both);
+
+    // prints:
+    // let(all = union(a, b), includes(all, a) && includes(all, b))
+    // 1, unions: 1
+    std::cout << check << std::endl;
+    std::cout << check(std::set<int>{1, 2}, std::set<int>{2, 3})
+              << ", unions: " << unions << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,53 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the math functions
+ */
+
+//! [full]
+#include <iostream>
+#include <vector>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    auto distance = sqrt(pow(x, 2) + pow(y, 2));
+    auto clamped = min(max(x, 0.0), 1.0);
+
+    // prints:
+    // sqrt(pow(x, 2) + pow(y, 2))
+    // min(max(x, 0), 1)
+    std::cout << distance << std::endl << clamped << std::endl;
+
+    // prints:
+    // 5 1 0.5
+    std::cout << distance(3.0, 4.0) << " " << clamped(7.5) << " "
+              << clamped(0.5) << std::endl;
+
+    // evaluated over columns of values; the loop vectorizes if
+    // CTAEB_APPROXIMATE_MATH is defined
+    auto ratio = exp(abs(log(x) - log(y)));
+    std::vector<double> xs = {1.0, 10.0, 100.0};
+    std::vector<double> ys = {10.0, 10.0, 1.0};
+    std::vector<double> out(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        out[i] = ratio(xs[i], ys[i]);
+    }
+
+    // prints:
+    // 10 1 100
+    for (double value : out) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,28 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the `ctaeb` named module
+ */
+
+//! [full]
+#include <iostream>
+
+import ctaeb;
+
+int main() {
+    ctaeb::Variable<1> x("x");
+    ctaeb::Variable<2> y("y");
+
+    auto in_range = x + y < 10 && !(x == y);
+
+    // prints:
+    // x + y < 10 && not x == y: 1
+    std::cout << in_range << ": " << in_range(3, 4) << std::endl;
+
+    return 0;
+}
+//! [full]
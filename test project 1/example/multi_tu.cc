@@ -0,0 +1,33 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates a program that uses ctaeb in more than one translation
+ * unit; see also `multi_tu_invariants.cc`.
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+// defined in multi_tu_invariants.cc
+bool check_size_invariant(std::ostream &os, int before, int after);
+
+int main() {
+    Variable<1> a("a");
+    Variable<2> b("b");
+
+    auto difference = a - b;
+
+    // prints:
+    // a - b = 1
+    // _2 == _1 + 1
+    std::cout << difference << " = " << difference(3, 2) << std::endl;
+    return check_size_invariant(std::cout, 2, 3) ? 0 : 1;
+}
+//! [full]
@@ -0,0 +1,26 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief The second translation unit of the `multi_tu.cc` example. It
+ * includes `ctaeb.h` and prints expressions as well, which wouldn't link if
+ * the library's headers contained non-inline definitions.
+ */
+
+#include <ostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+bool check_size_invariant(std::ostream &os, int before, int after) {
+    Variable<1> size_before;
+    Variable<2> size_after;
+
+    auto invariant = size_after == size_before + 1;
+    os << invariant << std::endl;
+
+    return invariant(before, after);
+}
@@ -0,0 +1,33 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates evaluation with named arguments (C++20)
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> width("width");
+    Variable<2> height("height");
+    Variable<3> limit("limit");
+
+    auto fits = named<"width", "height", "limit">(width * height <= limit);
+
+    // prints:
+    // 1 0
+    std::cout << fits(arg<"limit"> = 100, arg<"width"> = 5, arg<"height"> = 20) << " "
+              << fits(arg<"height"> = 20, arg<"width"> = 6, arg<"limit"> = 100) << std::endl;
+
+    // does not compile: no value is given for the variable "limit"
+    // fits(arg<"width"> = 5, arg<"height"> = 20);
+    return 0;
+}
+//! [full]
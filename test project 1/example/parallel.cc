@@ -0,0 +1,69 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the class `Parallel`
+ */
+
+//! [full]
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+/**
+ * The difference of two sets.
+ */
+template<typename T = void>
+struct set_difference {
+    template<typename Set>
+    Set operator()(const Set &set1, const Set &set2) const {
+        Set result;
+        std::set_difference(set1.begin(), set1.end(),
+                            set2.begin(), set2.end(),
+                            std::inserter(result, result.end()));
+        return result;
+    }
+};
+
+namespace ctaeb {
+template<typename... T>
+struct cost<set_difference, T...> : std::integral_constant<std::size_t, 1000> {
+};
+} //::ctaeb
+
+int main() {
+    Variable<1> a("a");
+    Variable<2> b("b");
+    Variable<3> c("c");
+
+    auto difference = [](auto &&x, auto &&y) {
+        return Compound<set_difference, std::decay_t<decltype(x)>,
+                        std::decay_t<decltype(y)>>(x, y);
+    };
+
+    // the two differences are computed concurrently
+    auto same_difference = difference(a, c) == difference(b, c);
+
+    std::set<int> x, y, z;
+    for (int i = 0; i < 100000; ++i) {
+        x.insert(i);
+        y.insert(i);
+        z.insert(2 * i);
+    }
+
+    ThreadPool pool(2);
+    auto check = parallel(same_difference, pool);
+
+    // prints:
+    // 1 1
+    std::cout << check(x, y, z) << " " << same_difference(x, y, z) << std::endl;
+    return 0;
+}
+//! [full]
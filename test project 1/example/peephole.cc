@@ -0,0 +1,35 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of `optimize`
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> code("code");
+    Variable<2> port("port");
+
+    auto rule = (code >= 200 && code < 300) || (port == 80 || port == 443 || port == 8080);
+    auto fast = optimize(rule);
+
+    // prints:
+    // code >= 200 && code < 300 || port == 80 || port == 443 || port == 8080
+    // in_range(code, 200, 300) || one_of(port, {80, 443, 8080})
+    std::cout << rule << std::endl << fast << std::endl;
+
+    // prints:
+    // 1 1 0 1
+    std::cout << fast(250, 0) << " " << fast(0, 443) << " "
+              << fast(300, 81) << " " << rule(404, 8080) << std::endl;
+    return 0;
+}
+//! [full]
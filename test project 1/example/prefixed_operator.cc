@@ -16,6 +16,7 @@
 
 using namespace ctaeb;
 
+// evaluates both branches; the built-in `select` evaluates only one of them
 template <typename U = void>
 struct CustomOperator {
     static constexpr bool prefixed = true;
@@ -29,7 +30,7 @@ struct CustomOperator {
 
 namespace ctaeb { namespace print {
 template<>
-std::string to_string<::CustomOperator>() {
+inline std::string to_string<::CustomOperator>() {
     return "?:";
 }
 } }
@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of user-defined rewrite rules
+ */
+
+//! [full]
+#include <iostream>
+#include <type_traits>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+// converts degrees Celsius to degrees Fahrenheit
+template<typename T = void>
+struct to_fahrenheit {
+    static constexpr bool prefixed = true;
+
+    template<typename U>
+    constexpr auto operator()(const U &value) const {
+        return value * 9 / 5 + 32;
+    }
+};
+
+// converts degrees Fahrenheit to degrees Celsius
+template<typename T = void>
+struct to_celsius {
+    static constexpr bool prefixed = true;
+
+    template<typename U>
+    constexpr auto operator()(const U &value) const {
+        return (value - 32) * 5 / 9;
+    }
+};
+
+template<typename E, typename = Expression<E>>
+auto fahrenheit(const E &expr) {
+    return Compound<to_fahrenheit, E>(expr);
+}
+
+template<typename E, typename = Expression<E>>
+auto celsius(const E &expr) {
+    return Compound<to_celsius, E>(expr);
+}
+
+namespace ctaeb {
+
+// the conversions are inverse to each other
+template<>
+struct rewrite_rules<to_celsius> {
+    using type = std::tuple<
+        Rule<Compound<to_celsius, Compound<to_fahrenheit, Placeholder<1>>>, Placeholder<1>>>;
+};
+
+template<>
+struct rewrite_rules<to_fahrenheit> {
+    using type = std::tuple<
+        Rule<Compound<to_fahrenheit, Compound<to_celsius, Placeholder<1>>>, Placeholder<1>>>;
+};
+
+namespace print {
+
+template<>
+inline std::string to_string<::to_fahrenheit>() {
+    return "fahrenheit";
+}
+
+template<>
+inline std::string to_string<::to_celsius>() {
+    return "celsius";
+}
+
+} //::print
+
+} //::ctaeb
+
+int main() {
+    Variable<1> t("t");
+    Variable<2> limit("limit");
+
+    auto e = celsius(fahrenheit(t)) > celsius(limit);
+    auto r = rewrite(e);
+    static_assert(std::is_same<decltype(r),
+        Compound<std::greater, Variable<1>, Compound<to_celsius, Variable<2>>>>::value, "");
+
+    // prints:
+    // celsius(fahrenheit(t)) > celsius(limit)
+    // t > celsius(limit)
+    std::cout << e << std::endl << r << std::endl;
+
+    // prints:
+    // 1 1
+    std::cout << e(40.0, 95.0) << " " << r(40.0, 95.0) << std::endl;
+    return 0;
+}
+//! [full]
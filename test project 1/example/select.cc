@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of `select` and `blend`
+ */
+
+//! [full]
+#include <iostream>
+#include <vector>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    // x / y is not evaluated when y is 0
+    auto ratio = select(y != 0, x / y, 0);
+
+    // prints:
+    // select(y != 0, x / y, 0)
+    // 5 0
+    std::cout << ratio << std::endl;
+    std::cout << ratio(10, 2) << " " << ratio(10, 0) << std::endl;
+
+    // both values are computed, and one of them is chosen without a jump
+    auto clamp = blend(x > 100, 100, x);
+    std::vector<int> values = {5, 500, 50, 5000};
+    std::vector<int> clamped(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        clamped[i] = clamp(values[i]);
+    }
+
+    // prints:
+    // 5 100 50 100
+    for (int value : clamped) {
+        std::cout << value << " ";
+    }
+    std::cout << std::endl;
+    return 0;
+}
+//! [full]
@@ -0,0 +1,73 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the functions `serialize` and `load`
+ */
+
+//! [full]
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <ctaeb/ctaeb.h>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace ctaeb;
+
+// the types of the expressions are shared by the writer and the readers
+inline auto size_invariant() {
+    return Variable<2>("size_after") == Variable<1>("size_before") + 1;
+}
+
+inline auto range_invariant() {
+    return Variable<1>("x") >= 0.5 && Variable<1>("x") < 10.0;
+}
+
+using SizeInvariant = decltype(size_invariant());
+using RangeInvariant = decltype(range_invariant());
+
+int main() {
+    const char *path = "ctaeb-serialize-example.bin";
+
+    // the writer: two expressions back to back
+    std::vector<unsigned char> bytes;
+    serialize(bytes, size_invariant());
+    serialize(bytes, range_invariant());
+    std::ofstream(path, std::ios::binary).write(
+        reinterpret_cast<const char *>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size()));
+
+    // a reader: maps the file and evaluates the expressions in place
+#if __has_include(<sys/mman.h>)
+    int fd = open(path, O_RDONLY);
+    void *data = mmap(nullptr, bytes.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+#else
+    void *data = bytes.data();
+#endif
+    auto size = load<SizeInvariant>(data);
+    auto range = load<RangeInvariant>(
+        static_cast<const unsigned char *>(data) + block_size(data));
+
+    // prints:
+    // size_after == size_before + 1: 1
+    // x >= 0.5 && x < 10: 0
+    std::cout << size << ": " << size(1, 2) << std::endl;
+    std::cout << range << ": " << range(12.0) << std::endl;
+
+#if __has_include(<sys/mman.h>)
+    munmap(data, bytes.size());
+    close(fd);
+#endif
+    std::remove(path);
+    return 0;
+}
+//! [full]
@@ -0,0 +1,46 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Demonstrates usage of the class `Table`
+ */
+
+//! [full]
+#include <iostream>
+#include <ctaeb/ctaeb.h>
+
+using namespace ctaeb;
+
+int main() {
+    Variable<1> x("x");
+    Variable<2> y("y");
+
+    // y != x && 10 / y < x
+    Table<Variable<1>,                   // 0: x
+          Variable<2>,                   // 1: y
+          Node<std::not_equal_to, 1, 0>, // 2: y != x
+          Constant<int>,                 // 3: 10
+          Node<std::divides, 3, 1>,      // 4: 10 / y
+          Node<std::less, 4, 0>,         // 5: 10 / y < x
+          Node<std::logical_and, 2, 5>>  // 6: 2 && 5
+        check{x, y, {}, 10, {}, {}, {}};
+
+    // prints:
+    // y != x && 10 / y < x
+    std::cout << check << std::endl;
+    // prints (10 / y is never evaluated for y = 0):
+    // 0 1
+    std::cout << check(0, 0) << " " << check(3, 5) << std::endl;
+
+    // a table is an expression and may be nested into compounds
+    auto negated = !check;
+    // prints:
+    // 0
+    std::cout << negated(3, 5) << std::endl;
+
+    return 0;
+}
+//! [full]
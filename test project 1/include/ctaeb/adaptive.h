@@ -0,0 +1,258 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `Adaptive`, an evaluator of @em && and @em || chains that
+ * reorders their operands based on the observed cost and selectivity.
+ */
+
+#ifndef CTAEB_ADAPTIVE_H
+#define CTAEB_ADAPTIVE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+#include "instrumentation.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+/**
+ * Collects the operands of a chain of `Op` into a tuple: `a && b && c` is
+ * `(a && b) && c`, which becomes `std::tuple<A, B, C>`.
+ */
+template<template<typename...> typename Op, typename E>
+struct chain_operands {
+    using type = std::tuple<E>;
+
+    static type get(const E &expr) {
+        return type(expr);
+    }
+};
+
+template<template<typename...> typename Op, typename E1, typename E2>
+struct chain_operands<Op, Compound<Op, E1, E2>> {
+    using First = chain_operands<Op, std::decay_t<E1>>;
+    using Second = chain_operands<Op, std::decay_t<E2>>;
+    using type = decltype(std::tuple_cat(std::declval<typename First::type>(),
+                                         std::declval<typename Second::type>()));
+
+    static type get(const Compound<Op, E1, E2> &expr) {
+        const auto &operands = expr.get_expressions();
+        return std::tuple_cat(First::get(std::get<0>(operands)),
+                              Second::get(std::get<1>(operands)));
+    }
+};
+
+template<template<typename...> typename Op>
+struct chain_traits;
+
+/**
+ * Evaluation of @em && stops at the first operand that is @em false; an
+ * operand is the more useful the more often it stops the evaluation.
+ */
+template<>
+struct chain_traits<std::logical_and> {
+    static constexpr bool stop_on = false;
+};
+
+template<>
+struct chain_traits<std::logical_or> {
+    static constexpr bool stop_on = true;
+};
+
+template<typename T>
+struct adaptive_chain;
+
+template<typename... Operands>
+struct adaptive_chain<std::tuple<Operands...>> {
+    static constexpr std::array<bool, sizeof...(Operands)> pure = {{
+        is_pure<std::decay_t<Operands>>::value...
+    }};
+};
+
+} //::detail
+
+/**
+ * Evaluates a chain of operands joined by `Op` (@em std::logical_and or
+ * @em std::logical_or) in an order that changes at runtime. Every
+ * `sample_period`-th evaluation measures the cycles spent in each operand
+ * and whether it stopped the evaluation; every `reorder_period` evaluations
+ * the operands are sorted by the expected cost of reaching a result, which
+ * is the operand's cost divided by the probability that it stops
+ * the evaluation. The statistics are then halved, so that the order follows
+ * the changes in the input data.
+ *
+ * Only pure operands (see `is_pure_operation`) are reordered, and only
+ * among neighbouring pure operands: an operand that may fail, such as
+ * `10 / y < x` in `y != 0 && 10 / y < x`, keeps its place, and so do all
+ * the operands that may guard it.
+ *
+ * An `Adaptive` object updates its statistics during evaluation and must not
+ * be evaluated by several threads at once; use a copy per thread.
+ */
+template<template<typename...> typename Op, typename Operands>
+class Adaptive {
+    static constexpr std::size_t size = std::tuple_size<Operands>::value;
+    static constexpr bool stop_on = detail::chain_traits<Op>::stop_on;
+
+    struct Statistics {
+        std::uint64_t samples;
+        std::uint64_t stops;
+        std::uint64_t cycles;
+    };
+
+  public:
+    /**
+     * Constructs an evaluator of the given operands in the order in which
+     * they were written.
+     */
+    explicit Adaptive(const Operands &operands,
+                      std::uint64_t sample_period = 16,
+                      std::uint64_t reorder_period = 1024)
+        : operands_(operands),
+          sample_period_(sample_period),
+          reorder_period_(reorder_period) {
+        for (std::size_t i = 0; i < size; ++i) {
+            order_[i] = i;
+            statistics_[i] = Statistics{0, 0, 0};
+        }
+    }
+
+    template<typename... Args>
+    bool operator()(Args &&... args) const {
+        ++calls_;
+        bool sample = calls_ % sample_period_ == 0;
+        bool result = !stop_on;
+        for (std::size_t i : order_) {
+            std::uint64_t start = sample ? instrumentation::clock() : 0;
+            bool value = evaluate(i, std::make_index_sequence<size>(), args...);
+            if (sample) {
+                auto &s = statistics_[i];
+                s.cycles += instrumentation::clock() - start;
+                ++s.samples;
+                s.stops += value == stop_on;
+            }
+            if (value == stop_on) {
+                result = stop_on;
+                break;
+            }
+        }
+        if (calls_ % reorder_period_ == 0) {
+            reorder();
+        }
+        return result;
+    }
+
+    /**
+     * The operands in the order they were written.
+     */
+    const Operands &operands() const {
+        return operands_;
+    }
+
+    /**
+     * The current evaluation order, as indices into `operands()`.
+     */
+    const std::array<std::size_t, size> &order() const {
+        return order_;
+    }
+
+  private:
+    template<std::size_t... I, typename... Args>
+    bool evaluate(std::size_t index, std::index_sequence<I...>, Args &... args) const {
+        bool value = false;
+        static_cast<void>(
+            ((index == I && (value = static_cast<bool>(std::get<I>(operands_)(args...)), true)) || ...));
+        return value;
+    }
+
+    /**
+     * Operands that were never sampled get the lowest cost, thus they're
+     * tried first and sampled next time. Operands that never stop
+     * the evaluation go last.
+     */
+    double expected_cost(std::size_t i) const {
+        const auto &s = statistics_[i];
+        if (s.samples == 0) {
+            return 0;
+        }
+        double cost = static_cast<double>(s.cycles) / s.samples;
+        double stop_rate = static_cast<double>(s.stops) / s.samples;
+        return stop_rate > 0 ? cost / stop_rate
+                             : std::numeric_limits<double>::infinity();
+    }
+
+    void reorder() const {
+        constexpr auto &pure = detail::adaptive_chain<Operands>::pure;
+        std::array<double, size> cost;
+        for (std::size_t i = 0; i < size; ++i) {
+            cost[i] = expected_cost(i);
+        }
+        auto by_cost = [&cost](std::size_t i1, std::size_t i2) {
+            return cost[i1] < cost[i2];
+        };
+        // pure operands are sorted within the runs bounded by impure ones
+        auto begin = order_.begin();
+        while (begin != order_.end()) {
+            auto end = std::find_if(begin, order_.end(), [&pure](std::size_t i) {
+                return !pure[i];
+            });
+            std::stable_sort(begin, end, by_cost);
+            begin = end == order_.end() ? end : end + 1;
+        }
+        // operands that are rarely reached keep their last measurement
+        for (auto &s : statistics_) {
+            if (s.samples > 1) {
+                s.samples /= 2;
+                s.stops /= 2;
+                s.cycles /= 2;
+            }
+        }
+    }
+
+    Operands operands_;
+    std::uint64_t sample_period_;
+    std::uint64_t reorder_period_;
+    mutable std::uint64_t calls_ = 0;
+    mutable std::array<std::size_t, size> order_;
+    mutable std::array<Statistics, size> statistics_;
+};
+
+/**
+ * Creates an adaptive evaluator of the top-level @em && or @em || chain of
+ * `expr`; see `Adaptive`:
+ * @code
+ * auto filter = adaptive(x > 0 && y < 7 && z != 3);
+ * std::size_t passed = std::count_if(rows.begin(), rows.end(), [&](const Row &r) {
+ *     return filter(r.x, r.y, r.z);
+ * });
+ * @endcode
+ */
+template<template<typename...> typename Op, typename E1, typename E2,
+         typename = std::enable_if_t<std::is_same<Op<void>, std::logical_and<void>>::value ||
+                                     std::is_same<Op<void>, std::logical_or<void>>::value>>
+auto adaptive(const Compound<Op, E1, E2> &expr,
+              std::uint64_t sample_period = 16,
+              std::uint64_t reorder_period = 1024) {
+    using Chain = detail::chain_operands<Op, Compound<Op, E1, E2>>;
+    return Adaptive<Op, typename Chain::type>(
+        Chain::get(expr), sample_period, reorder_period);
+}
+
+} //::ctaeb
+
+#endif //CTAEB_ADAPTIVE_H
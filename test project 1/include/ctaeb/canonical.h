@@ -0,0 +1,387 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines the canonical form of expressions, in which structurally
+ * identical sub-expressions have identical types, and the normalized form,
+ * which also orders the operands of commutative operations.
+ */
+
+#ifndef CTAEB_CANONICAL_H
+#define CTAEB_CANONICAL_H
+
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+/**
+ * Computes the canonical type of the expression `T`; see `canonical_t`.
+ * Expressions that are not constants, variables, or compounds (such as
+ * tables) are canonical as they are.
+ */
+template<typename T>
+struct canonical {
+    using type = std::remove_cv_t<std::remove_reference_t<T>>;
+};
+
+template<typename T>
+struct canonical<Constant<T>> {
+    using type = Constant<std::decay_t<T>>;
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct canonical<Compound<Op, Nested...>> {
+    using type = Compound<Op, typename canonical<
+        std::remove_cv_t<std::remove_reference_t<Nested>>>::type...>;
+};
+
+template<typename T>
+const T &canonicalize(const T &expr) {
+    return expr;
+}
+
+template<typename T>
+Constant<std::decay_t<T>> canonicalize(const Constant<T> &expr) {
+    return Constant<std::decay_t<T>>(expr());
+}
+
+template<template<typename...> typename Op, typename... Nested>
+typename canonical<Compound<Op, Nested...>>::type
+canonicalize(const Compound<Op, Nested...> &expr);
+
+template<template<typename...> typename Op, typename... Nested,
+         std::size_t... I>
+auto canonicalize(const Compound<Op, Nested...> &expr,
+                  std::index_sequence<I...>) {
+    using Result = typename canonical<Compound<Op, Nested...>>::type;
+    return Result(canonicalize(std::get<I>(expr.get_expressions()))...);
+}
+
+template<template<typename...> typename Op, typename... Nested>
+typename canonical<Compound<Op, Nested...>>::type
+canonicalize(const Compound<Op, Nested...> &expr) {
+    return canonicalize(expr, std::index_sequence_for<Nested...>());
+}
+
+} //::detail
+
+/**
+ * The canonical type of the expression `E`. Compounds built by the operators
+ * refer to the named sub-expressions and own the temporary ones, so the
+ * types of `x + y` and `Variable<1>() + Variable<2>()` are different, and so
+ * are the types of two identical sub-expressions of which one was built from
+ * named variables. Each type instantiates its own `operator()`, `Invoker`,
+ * and `operator<<`. In the canonical form every sub-expression is held by
+ * value and every constant has a decayed value type; the type of an
+ * expression then depends on its structure only, and structurally identical
+ * sub-expressions share their instantiations, even across expressions.
+ */
+template<typename E>
+using canonical_t = typename detail::canonical<
+    std::remove_cv_t<std::remove_reference_t<E>>>::type;
+
+/**
+ * Converts the expression to its canonical form; see `canonical_t`. The
+ * result copies all the sub-expressions and thus doesn't refer to the
+ * variables it was built from:
+ * @code
+ * Variable<1> x("x");
+ * auto e = canonical(x + 1);
+ * static_assert(std::is_same_v<decltype(e), decltype(Variable<1>() + 1)>);
+ * @endcode
+ */
+template<typename E, typename = Expression<E>>
+canonical_t<E> canonical(const E &expr) {
+    return detail::canonicalize(expr);
+}
+
+/**
+ * Tells whether the operands of the binary operation `Op` applied to the
+ * expressions `E1` and `E2` may be swapped; used by `normalize`. May be
+ * specialized for user-defined operations.
+ */
+template<template<typename...> typename Op, typename E1, typename E2>
+struct is_commutative : std::false_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::plus, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::multiplies, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::equal_to, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::not_equal_to, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::bit_and, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::bit_or, E1, E2> : std::true_type {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::bit_xor, E1, E2> : std::true_type {
+};
+
+/**
+ * Tells whether the operation `Op` is defined for all operand values and has
+ * no side effects. Arithmetic operations are not, because of division by
+ * zero and overflow, and neither are shifts, because of out of range shift
+ * counts. May be specialized for user-defined operations.
+ */
+template<template<typename...> typename Op>
+struct is_pure_operation : std::false_type {
+};
+
+template<>
+struct is_pure_operation<std::equal_to> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::not_equal_to> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::less> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::less_equal> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::greater> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::greater_equal> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::logical_and> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::logical_or> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::logical_not> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::bit_and> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::bit_or> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::bit_xor> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<std::bit_not> : std::true_type {
+};
+
+namespace detail {
+
+/**
+ * An expression is pure if all of its operations are; see
+ * `is_pure_operation`.
+ */
+template<typename>
+struct is_pure : std::false_type {
+};
+
+template<std::size_t N>
+struct is_pure<Variable<N>> : std::true_type {
+};
+
+template<typename T>
+struct is_pure<Constant<T>> : std::true_type {
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct is_pure<Compound<Op, Nested...>>
+    : std::conjunction<is_pure_operation<Op>, is_pure<std::decay_t<Nested>>...> {
+};
+
+} //::detail
+
+/**
+ * `&&` and `||` evaluate their second operand only when necessary, thus
+ * a guard like `y != 0 && x / y > 1` must stay in its place. If both
+ * operands are pure, the order of evaluation doesn't matter.
+ */
+template<typename E1, typename E2>
+struct is_commutative<std::logical_and, E1, E2>
+    : std::conjunction<detail::is_pure<E1>, detail::is_pure<E2>> {
+};
+
+template<typename E1, typename E2>
+struct is_commutative<std::logical_or, E1, E2>
+    : std::conjunction<detail::is_pure<E1>, detail::is_pure<E2>> {
+};
+
+namespace detail {
+
+/**
+ * Returns a string that is unique for `T`; the compilers put the template
+ * arguments into the name of the function.
+ */
+template<typename T>
+constexpr std::string_view type_signature() {
+#if defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+template<typename>
+struct variable_index : std::integral_constant<std::size_t, 0> {
+};
+
+template<std::size_t N>
+struct variable_index<Variable<N>> : std::integral_constant<std::size_t, N> {
+};
+
+template<typename T>
+constexpr int order_rank() {
+    return is_variable<T>::value ? 0 : is_constant<T>::value ? 1 : 2;
+}
+
+/**
+ * The order of operands in the normalized form: variables by their indices
+ * first, then constants, then everything else. Types of the same rank are
+ * ordered by their signatures, which is arbitrary but consistent within
+ * a program built by one compiler.
+ */
+template<typename T1, typename T2>
+constexpr bool precedes() {
+    if (order_rank<T1>() != order_rank<T2>()) {
+        return order_rank<T1>() < order_rank<T2>();
+    }
+    if (variable_index<T1>::value != variable_index<T2>::value) {
+        return variable_index<T1>::value < variable_index<T2>::value;
+    }
+    return type_signature<T1>() < type_signature<T2>();
+}
+
+/**
+ * Computes the normalized type of a canonical expression `T`.
+ */
+template<typename T>
+struct normalized {
+    using type = T;
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct normalized<Compound<Op, Nested...>> {
+    using type = Compound<Op, typename normalized<Nested>::type...>;
+};
+
+template<template<typename...> typename Op, typename E1, typename E2>
+struct normalized<Compound<Op, E1, E2>> {
+    using N1 = typename normalized<E1>::type;
+    using N2 = typename normalized<E2>::type;
+    static constexpr bool swap =
+        is_commutative<Op, N1, N2>::value && precedes<N2, N1>();
+    using type = std::conditional_t<swap,
+                                    Compound<Op, N2, N1>,
+                                    Compound<Op, N1, N2>>;
+};
+
+template<typename T>
+const T &reorder(const T &expr) {
+    return expr;
+}
+
+template<template<typename...> typename Op, typename... Nested>
+typename normalized<Compound<Op, Nested...>>::type
+reorder(const Compound<Op, Nested...> &expr);
+
+template<template<typename...> typename Op, typename... Nested,
+         std::size_t... I>
+auto reorder(const Compound<Op, Nested...> &expr,
+               std::index_sequence<I...>) {
+    using Result = typename normalized<Compound<Op, Nested...>>::type;
+    return Result(reorder(std::get<I>(expr.get_expressions()))...);
+}
+
+template<template<typename...> typename Op, typename E1, typename E2>
+auto reorder(const Compound<Op, E1, E2> &expr, std::index_sequence<0, 1>) {
+    using Result = typename normalized<Compound<Op, E1, E2>>::type;
+    const auto &operands = expr.get_expressions();
+    if constexpr (normalized<Compound<Op, E1, E2>>::swap) {
+        return Result(reorder(std::get<1>(operands)),
+                      reorder(std::get<0>(operands)));
+    } else {
+        return Result(reorder(std::get<0>(operands)),
+                      reorder(std::get<1>(operands)));
+    }
+}
+
+template<template<typename...> typename Op, typename... Nested>
+typename normalized<Compound<Op, Nested...>>::type
+reorder(const Compound<Op, Nested...> &expr) {
+    return reorder(expr, std::index_sequence_for<Nested...>());
+}
+
+} //::detail
+
+/**
+ * The canonical type of the expression `E`, in which the operands of every
+ * commutative operation (see `is_commutative`) are put in a fixed order.
+ * Thus `_1 + _2` and `_2 + _1` have the same normalized type
+ * `Compound<std::plus, Variable<1>, Variable<2>>`, and so do any two
+ * expressions that differ only in the order of commutative operands.
+ *
+ * Commutativity is a property of the operation applied to particular value
+ * types, which aren't known until the evaluation. `std::plus` of two
+ * strings, for one, is not commutative; normalize only expressions whose
+ * value types behave as `is_commutative` says.
+ */
+template<typename E>
+using normalized_t = typename detail::normalized<canonical_t<E>>::type;
+
+/**
+ * Converts the expression to its normalized form; see `normalized_t`:
+ * @code
+ * Variable<1> x("x");
+ * Variable<2> y("y");
+ * auto e1 = normalize(y * 2 == x + y);
+ * auto e2 = normalize(x + y == 2 * y);
+ * static_assert(std::is_same_v<decltype(e1), decltype(e2)>);
+ * @endcode
+ */
+template<typename E, typename = Expression<E>>
+normalized_t<E> normalize(const E &expr) {
+    return detail::reorder(detail::canonicalize(expr));
+}
+
+} //::ctaeb
+
+#endif //CTAEB_CANONICAL_H
@@ -0,0 +1,100 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `Context`, which provides memory for the intermediate results
+ * of an evaluation.
+ */
+
+#ifndef CTAEB_CONTEXT_H
+#define CTAEB_CONTEXT_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace ctaeb {
+
+/**
+ * Evaluation context: an arena that the operations of an expression may
+ * allocate their results from. A context is passed to an expression as
+ * the first argument, before the values of the variables:
+ * @code
+ * Context context;
+ * bool ok = invariant(context, x, y);
+ * context.release();
+ * @endcode
+ * An operation opts in by accepting `std::pmr::memory_resource *` as its
+ * first parameter; operations that don't are called as usual. The memory is
+ * never freed one allocation at a time, it's returned all at once by
+ * `release()`, which makes allocation a pointer increment most of the time.
+ * The results of the evaluations made since the last `release()` may refer
+ * to the arena, so the context must be released only after they're no longer
+ * used.
+ */
+class Context {
+  public:
+    /**
+     * Constructs a context whose arena allocates memory from `upstream` in
+     * growing chunks.
+     */
+    explicit Context(std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : arena_(upstream) {
+    }
+
+    /**
+     * Constructs a context whose arena uses `buffer` of the given size
+     * first, and then allocates from `upstream`. If the memory allocated
+     * between two calls to `release()` fits into the buffer, no memory is
+     * allocated from `upstream` at all.
+     */
+    Context(void *buffer, std::size_t size,
+            std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+        : arena_(buffer, size, upstream) {
+    }
+
+    Context(const Context &) = delete;
+    Context &operator=(const Context &) = delete;
+
+    /**
+     * The resource that operations allocate from.
+     */
+    std::pmr::memory_resource *resource() {
+        return &arena_;
+    }
+
+    /**
+     * Releases all the memory allocated from `resource()`.
+     */
+    void release() {
+        arena_.release();
+    }
+
+  private:
+    std::pmr::monotonic_buffer_resource arena_;
+};
+
+namespace detail {
+
+/**
+ * Calls `op` with the memory resource of `context` followed by `values`,
+ * if `op` accepts it, or with `values` only.
+ */
+template<typename Operation, typename... Values>
+decltype(auto) invoke_in(Context &context, const Operation &op, Values &&... values) {
+    if constexpr (std::is_invocable<const Operation &, std::pmr::memory_resource *, Values...>::value) {
+        return op(context.resource(), std::forward<Values>(values)...);
+    } else {
+        return op(std::forward<Values>(values)...);
+    }
+}
+
+} //::detail
+
+} //::ctaeb
+
+#endif //CTAEB_CONTEXT_H
@@ -0,0 +1,135 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `cost`, the estimated cost of operations, and
+ * `expression_cost`, its sum over an expression.
+ */
+
+#ifndef CTAEB_COST_H
+#define CTAEB_COST_H
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+
+namespace ctaeb {
+
+/**
+ * Estimated cost of applying the operation `Op` to the values of the types
+ * `T...`, in arbitrary units; every operation costs 1 unless specialized.
+ * Evaluators that choose a strategy, such as `parallel` and `filter`, use
+ * the sum of the costs over an expression (see `expression_cost`). May be
+ * specialized for built-in and user-defined operations, either for all
+ * operand types:
+ * @code
+ * template<typename... T>
+ * struct ctaeb::cost<set_difference, T...> : std::integral_constant<std::size_t, 1000> {};
+ * @endcode
+ * or for some of them:
+ * @code
+ * template<>
+ * struct ctaeb::cost<std::plus, std::string, std::string> : std::integral_constant<std::size_t, 10> {};
+ * @endcode
+ */
+template<template<typename...> typename Op, typename... T>
+struct cost : std::integral_constant<std::size_t, 1> {
+};
+
+namespace detail {
+
+/**
+ * The type of the value of `E` evaluated with the arguments of the types
+ * `Args...`.
+ */
+template<typename E, typename... Args>
+using result_t = std::decay_t<decltype(std::declval<const E &>()(std::declval<Args &>()...))>;
+
+} //::detail
+
+/**
+ * Estimated cost of evaluating the expression `E` with the arguments of
+ * the types `Args...`: the sum of `cost` over the compounds of `E`, where
+ * every operation is given the types of its operand values. Variables and
+ * constants cost nothing. Computed at compile time.
+ */
+template<typename E, typename... Args>
+struct expression_cost : std::integral_constant<std::size_t, 0> {
+};
+
+template<template<typename...> typename Op, typename... Nested, typename... Args>
+struct expression_cost<Compound<Op, Nested...>, Args...>
+    : std::integral_constant<std::size_t,
+                             (cost<Op, detail::result_t<std::decay_t<Nested>, Args...>...>::value + ... +
+                              expression_cost<std::decay_t<Nested>, Args...>::value)> {
+};
+
+/**
+ * Helper variable template for `expression_cost`.
+ */
+template<typename E, typename... Args>
+constexpr std::size_t expression_cost_v = expression_cost<E, Args...>::value;
+
+namespace detail {
+
+/**
+ * Returns the indices of operands sorted by `cost`, so that the cheapest go
+ * first. Only pure operands are moved, and only among neighbouring pure
+ * operands, because an impure operand may depend on the ones before it being
+ * evaluated first; see `Adaptive`. Operands of equal cost keep their order.
+ */
+template<std::size_t N>
+constexpr std::array<std::size_t, N> cheapest_first(const std::array<std::size_t, N> &costs,
+                                                    const std::array<bool, N> &pure) {
+    std::array<std::size_t, N> order{};
+    for (std::size_t i = 0; i < N; ++i) {
+        order[i] = i;
+    }
+    for (std::size_t i = 1; i < N; ++i) {
+        for (std::size_t j = i; j > 0 && pure[order[j]] && pure[order[j - 1]] &&
+                                costs[order[j]] < costs[order[j - 1]]; --j) {
+            std::size_t index = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = index;
+        }
+    }
+    return order;
+}
+
+/**
+ * The order in which the operands of a short-circuit chain, given as
+ * a tuple, are best evaluated with the arguments of the types `Args...`.
+ */
+template<typename Operands, typename... Args>
+struct cost_order;
+
+template<typename... Operands, typename... Args>
+struct cost_order<std::tuple<Operands...>, Args...> {
+    static constexpr std::size_t size = sizeof...(Operands);
+
+    static constexpr std::array<std::size_t, size> value = cheapest_first<size>(
+        {{expression_cost<std::decay_t<Operands>, Args...>::value...}},
+        {{is_pure<std::decay_t<Operands>>::value...}});
+
+    template<std::size_t... I>
+    static std::index_sequence<value[I]...> indices(std::index_sequence<I...>);
+
+    /**
+     * `value` as an @em std::index_sequence.
+     */
+    using type = decltype(indices(std::make_index_sequence<size>()));
+};
+
+} //::detail
+
+} //::ctaeb
+
+#endif //CTAEB_COST_H
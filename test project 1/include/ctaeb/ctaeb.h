@@ -104,6 +104,13 @@
  * It in turn includes all the necessary header files. It's possible to use
  * the library without `operations.h` or `print.h` included: just include
  * `expression.h` instead of `ctaeb.h`.
+ *
+ * With a C++20 compiler the library is also available as the named module
+ * `ctaeb` (target `ctaeb.module`, enabled by the cmake option
+ * `CTAEB_BUILD_MODULE`, requires cmake 3.28). The module exports the same
+ * declarations as `ctaeb.h`, so translation units that import it skip
+ * re-parsing the library and the standard headers it depends on:
+ * @snippet example/module.cc full
  * @section expressions_section Expressions
  * An expression is either a `Constant` expression, a `Variable`, or a
  * `Compound`. Compound expression joins one or more expressions by a function
@@ -159,9 +166,12 @@
  * namespace ctaeb { namespace print {
  * // return a string that prints the operation
  * template <>
- * std::string to_string<Operation>();
+ * inline std::string to_string<Operation>();
  * } //::print } //::ctaeb
  * @endcode
+ * An explicit specialization is an ordinary function, so if it's defined
+ * in a header, it must be declared @em inline to avoid multiple definition
+ * errors when that header is included by several translation units.
  * Infix and prefix operations are distinguished; see
  * `ctaeb::print::to_string()` and `ctaeb::print::prefixed` for further
  * information.
@@ -194,6 +204,153 @@
  * This process continues until all sub-expressions are evaluated. As can be
  * seen from the description above, recursion stops when it encounters a
  * constant or a variable.
+ *
+ * Arguments that are already stored in a @em std::tuple, @em std::pair, or
+ * @em std::array are passed with `apply` instead of being unpacked by
+ * the caller:
+ * @snippet example/expression.cc apply
+ *
+ * @subsection select_subsection Conditional expressions
+ * `ctaeb::select(condition, value1, value2)` is the expression counterpart
+ * of `condition ? value1 : value2`: like @em && and @em ||, it's evaluated
+ * lazily, and the branch that is not taken is never evaluated. When both
+ * values are cheap and safe to compute, `ctaeb::blend` computes both and
+ * chooses one without a jump, which lets loops over columns of values
+ * vectorize:
+ * @snippet example/select.cc full
+ *
+ * @subsection let_subsection Shared sub-expressions
+ * A sub-expression that appears in several places of an expression is
+ * evaluated as many times as it appears. `ctaeb::let` evaluates it once per
+ * evaluation and gives its value a name, a `ctaeb::Local`, that may be used
+ * in the rest of the expression any number of times:
+ * @code
+ * Local<1> t("t");
+ * auto e = let(t = a + b, t * t - t);
+ * @endcode
+ * This matters when the shared sub-expression is expensive, such as an
+ * operation on containers:
+ * @snippet example/let.cc full
+ *
+ * @subsection named_subsection Named arguments
+ * With a C++20 compiler, the values of the variables may also be given by
+ * name. `ctaeb::named` assigns the names to `Variable<1>`, `Variable<2>`, and
+ * so on, and the arguments `ctaeb::arg<"name"> = value` are matched to them at
+ * compile time, thus the call costs the same as a positional one. A missing,
+ * an unknown, or a repeated name is a compile-time error:
+ * @snippet example/named.cc full
+ *
+ * @subsection extern_evaluation_subsection Explicit instantiation
+ * Every translation unit that evaluates an expression instantiates its
+ * `operator()` and all the nested ones. If the same expression types are
+ * evaluated with the same argument types in many translation units, the
+ * evaluation may be instantiated once with `CTAEB_INSTANTIATE_EVALUATION`
+ * and declared with `CTAEB_EXTERN_EVALUATION` in a shared header:
+ * @snippet example/extern_evaluation.h declaration
+ * @snippet example/extern_evaluation_instances.cc instantiation
+ * Such an expression is then evaluated via `ctaeb::evaluate`, which takes
+ * the same signature:
+ * @snippet example/extern_evaluation.cc full
+ *
+ * @subsection function_pointer_subsection Function pointers
+ * C APIs and dispatch tables take plain function pointers, which
+ * `std::function` can't provide. `ctaeb::to_function_pointer` converts
+ * an expression of variables into a function pointer of the given
+ * signature, and an expression with constants into a `ctaeb::BoundFunction`,
+ * a function that takes a context pointer, and the pointer to
+ * the expression:
+ * @snippet example/function_pointer.cc full
+ *
+ * @subsection instrumentation_subsection Instrumentation
+ * If `CTAEB_INSTRUMENTATION` is defined (the cmake option of the same name
+ * defines it for all targets that use ctaeb), every evaluation of a compound
+ * expression counts its calls, short-circuits of @em && and @em ||, and the
+ * cycles spent in it. The counters are sharded between threads and updated
+ * without locks; `ctaeb::instrumentation::report` prints them next to each
+ * node. Without the macro, evaluation code is exactly the same as if
+ * instrumentation didn't exist.
+ * @snippet example/instrumentation.cc full
+ *
+ * @subsection adaptive_subsection Adaptive evaluation
+ * Operands of @em && and @em || are evaluated in the order they're written.
+ * For long chains of filters, `ctaeb::adaptive` creates an evaluator that
+ * samples the cost of each operand and how often it decides the result,
+ * and periodically reorders the operands so that the cheap and selective
+ * ones go first. Only pure operands are reordered, thus guards such as
+ * `y != 0` in `y != 0 && 10 / y < x` keep working:
+ * @snippet example/adaptive.cc full
+ *
+ * @subsection peephole_subsection Peephole optimization
+ * Rule sets are full of range checks such as `x >= low && x < high` and of
+ * membership tests such as `x == 1 || x == 5 || x == 9`, each evaluated as
+ * a chain of comparisons and jumps. `ctaeb::optimize` recognizes these
+ * shapes in the type of an expression and replaces them with
+ * `ctaeb::in_range` (one unsigned comparison for integers) and
+ * `ctaeb::one_of` (a bit test if the values are integers close to each
+ * other):
+ * @snippet example/peephole.cc full
+ *
+ * @subsection rewrite_subsection Rewrite rules
+ * Identities of user-defined operations, such as `f(g(x)) = h(x)`, are
+ * declared as rules over expression types by specializing
+ * `ctaeb::rewrite_rules`, with `ctaeb::Placeholder` standing for any
+ * sub-expression. `ctaeb::rewrite` applies the rules at compile time, and
+ * `ctaeb::optimize` applies them before its own patterns:
+ * @snippet example/rewrite.cc full
+ *
+ * @subsection filter_subsection Filtering
+ * Predicates are often evaluated over many rows of data. `ctaeb::filter`
+ * takes one column of values per variable and returns the indices of
+ * the matching rows (`ctaeb::filter_bitmap` returns a bitmap instead). The
+ * operands of a top-level @em && are applied one after another, each to
+ * the rows that passed the previous ones:
+ * @snippet example/filter.cc full
+ *
+ * @subsection serialization_subsection Serialization
+ * `ctaeb::serialize` writes an expression in a compact binary format: one
+ * record per node with its kind, operation identifier (`ctaeb::operation_id`),
+ * or variable index, followed by variable names and constant values, which
+ * must be trivially copyable. `ctaeb::load<E>` makes an expression of the
+ * type `E` from such a block, for instance from a memory-mapped file written
+ * by another process of the same program. The structure is checked against
+ * `E`, and the constants refer to the values in the block without copying:
+ * @snippet example/serialize.cc full
+ *
+ * @subsection hash_subsection Hashing and comparison
+ * `ctaeb::structurally_equal` tells whether two expressions have the same
+ * structure and equal constants, and `ctaeb::hash` returns a hash consistent
+ * with it. The structural part is computed from the type at compile time
+ * (`ctaeb::structure_hash_v`); only the constants are looked at during
+ * the call. Variable names are ignored:
+ * @snippet example/hash.cc full
+ *
+ * @subsection context_subsection Evaluation context
+ * Operations on user-defined types often allocate their results, such as
+ * strings or containers, and the intermediate results are freed as soon as
+ * the evaluation is over. An expression may be evaluated with a
+ * `ctaeb::Context` given before the values of the variables; operations that
+ * take `std::pmr::memory_resource *` as their first parameter then allocate
+ * from the context's monotonic arena, which is released all at once:
+ * @snippet example/context.cc full
+ *
+ * @subsection parallel_subsection Parallel evaluation
+ * When the operands of a compound are expensive and independent, such as
+ * set operations on large containers, `ctaeb::parallel` evaluates them as
+ * tasks of a work-stealing `ctaeb::ThreadPool`. An operand becomes a task
+ * only if the estimated cost of its sub-expression reaches the given
+ * threshold (see @ref cost_subsection); cheap operands are evaluated inline, and so are
+ * the operands of @em && and @em ||:
+ * @snippet example/parallel.cc full
+ *
+ * @subsection cost_subsection Cost model
+ * `ctaeb::cost<Op, T...>` estimates the cost of applying `Op` to the values
+ * of the types `T...`; every operation costs 1 unless `ctaeb::cost` is
+ * specialized for it. `ctaeb::expression_cost_v<E, Args...>` sums the costs
+ * over an expression at compile time. The evaluators use it to choose how
+ * to evaluate an expression without hints in the expression itself:
+ * `ctaeb::parallel` spawns tasks only for the operands that are expensive
+ * enough, and `ctaeb::parallel` and `ctaeb::filter` apply the cheapest pure
+ * operands of @em && and @em || first.
  * @section motivation_section Motivation
  * This library was created as a side development of a larger project dedicated
  * to container class testing. In the standard C++ library, container behavior
@@ -298,6 +455,30 @@
  * evaluation time, new objects may be constructed as a result of
  * intermediate operations, and that amy or may not lead to dynamic allocations
  * depending on the participating types.
+ *
+ * @subsection large_expressions_subsection Large expressions
+ * Each `Compound` nests the types of its sub-expressions, therefore an
+ * expression with thousands of operations exceeds the template instantiation
+ * depth of the compiler. Generated expressions of that size should use
+ * `ctaeb::Table` instead, which keeps the nodes in a flat list and refers to
+ * operands by their indices:
+ * @snippet example/table.cc full
+ *
+ * @subsection code_size_subsection Code size
+ * Every distinct expression type instantiates its own `operator()`,
+ * `Invoker`, and `operator<<`. Sub-expressions built from named variables
+ * refer to them, while the temporary ones are held by value, so the same
+ * sub-expression may appear under several types. `ctaeb::canonical` converts
+ * an expression into the form where the type depends on the structure only.
+ * `ctaeb::normalize` goes further and puts the operands of commutative
+ * operations (`ctaeb::is_commutative`) in a fixed order, so that `_1 + _2`
+ * and `_2 + _1` have the same type. The operands of `&&` and `||` are
+ * reordered only if they can't fail (`ctaeb::is_pure_operation`), because
+ * the first operand may guard the second one:
+ * @snippet example/canonical.cc full
+ * To see where the code goes, `ctaeb_code_size_report(<target>)` in
+ * `CMakeLists.txt` adds the target `<target>.code-size`, which prints the
+ * size of the functions instantiated for each compound type in `<target>`.
  * @section supported_data_types Supported data types
  * An expression may be built from any data types as long as the corresponding
  * operation's result type is @em Constructible from the corresponding
@@ -327,26 +508,57 @@
  * Below is an example of a class that implements logical xor:
  * @snippet example/custom_operator.cc full
  *
+ * An operation receives the values of its operands, which means that all of
+ * them are evaluated first. An operation that needs to evaluate only some of
+ * its operands, such as @em && and `ctaeb::select`, declares a static member
+ * @em lazy (see `ctaeb::is_lazy_operation`); it then receives a function
+ * object without parameters per operand, and calls only those it needs:
+ * @snippet example/lazy_operator.cc full
+ *
+ * `math.h` adds the functions `sqrt`, `exp`, `log`, `pow`, `abs`, `min`,
+ * and `max` of expressions, which are printed in prefix form. Define
+ * `CTAEB_APPROXIMATE_MATH` to evaluate `exp` and `log` of floating-point
+ * values with polynomial kernels that vectorize in loops over columns of
+ * values, at the cost of up to 1 ulp of error:
+ * @snippet example/math.cc full
+ *
  * The following arithmetic operations are supported by the library:
  * @code
  * X + Y
  * X - Y
  * X * Y
  * X / Y
+ * X % Y
  * X && Y
  * X || Y
  * X == Y
  * X != Y
+ * X & Y
+ * X | Y
+ * X ^ Y
+ * X << Y
+ * X >> Y
  * !X
  * -X
+ * ~X
  * @endcode
  *
+ * A stream is never the left operand of `<<` or `>>`, so that
+ * `std::cout << expr` prints the expression.
+ *
  * For the binary operations, combinations ('expression', 'expression'),
  * ('expression', 'value'), and ('value', 'expression') of @em X and @em Y are
  * implemented. For unary ones there's only variant, because the corresponding
  * operation is already defined for the value's type (or the code is incorrect).
  * In template parameters, @em E, @em E1, and @em E2 correspond to expression
  * types; @em T corresponds to the C++ value types.
+ *
+ * When compiled in C++20 mode, each binary operator is a single template
+ * constrained by the `ctaeb::expression_operands` concept instead of the three
+ * SFINAE overloads above; value operands are wrapped into `Constant` in the
+ * same way, so the resulting expression types are identical in both modes.
+ * This makes overload resolution noticeably cheaper in translation units with
+ * many expressions. Define `CTAEB_NO_CONCEPTS` to keep the C++17 overloads.
  * @section glossary_section Glossary
  * - @em Expression - syntactic construction in a traditional sense of
  * programming languages.
@@ -360,6 +572,22 @@
  */
 #include "expression.h"
 #include "operations.h"
+#include "evaluation.h"
+#include "function_pointer.h"
+#include "named.h"
+#include "let.h"
+#include "select.h"
+#include "math.h"
+#include "canonical.h"
+#include "rewrite.h"
+#include "peephole.h"
+#include "cost.h"
+#include "adaptive.h"
+#include "filter.h"
+#include "serialize.h"
+#include "hash.h"
+#include "parallel.h"
+#include "table.h"
 #include "print.h"
 
 #endif //CTAEB_CTAEB_H
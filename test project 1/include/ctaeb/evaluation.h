@@ -0,0 +1,78 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `Evaluation`, which allows evaluation of an expression with
+ * the given argument types to be instantiated once per program rather than
+ * once per translation unit.
+ */
+
+#ifndef CTAEB_EVALUATION_H
+#define CTAEB_EVALUATION_H
+
+#include <utility>
+
+namespace ctaeb {
+
+template<typename E, typename Signature>
+struct Evaluation;
+
+/**
+ * Evaluation of the expression type `E` with the signature `R(Args...)`.
+ * `call` is not inline, thus it can be explicitly instantiated in one
+ * translation unit and declared `extern` in the others:
+ * @code
+ * // invariants.h
+ * using Invariant = decltype(Variable<1>() < Variable<2>());
+ * CTAEB_EXTERN_EVALUATION(bool(int, int), Invariant);
+ *
+ * // invariants.cc
+ * CTAEB_INSTANTIATE_EVALUATION(bool(int, int), Invariant);
+ * @endcode
+ * Translation units that include `invariants.h` and call
+ * `evaluate<bool(int, int)>(invariant, x, y)` then don't instantiate
+ * `Compound::operator()` and the operations it invokes; they only emit
+ * a call. The result type is a part of the signature, because deducing it
+ * would require instantiating the evaluation anyway.
+ */
+template<typename E, typename R, typename... Args>
+struct Evaluation<E, R(Args...)> {
+    static R call(const E &expr, Args... args);
+};
+
+template<typename E, typename R, typename... Args>
+R Evaluation<E, R(Args...)>::call(const E &expr, Args... args) {
+    return expr(std::forward<Args>(args)...);
+}
+
+/**
+ * Evaluates `expr` via `Evaluation<E, Signature>`. The arguments are
+ * converted to the parameter types of `Signature`.
+ */
+template<typename Signature, typename E, typename... Args>
+decltype(auto) evaluate(const E &expr, Args &&... args) {
+    return Evaluation<E, Signature>::call(expr, std::forward<Args>(args)...);
+}
+
+} //::ctaeb
+
+/**
+ * Declares the evaluation of the expression type given as the second argument
+ * with the function type `Signature` as explicitly instantiated elsewhere.
+ * The expression type is the last argument, so that the commas in its
+ * template argument list don't need to be escaped.
+ */
+#define CTAEB_EXTERN_EVALUATION(Signature, ...) \
+    extern template struct ctaeb::Evaluation<__VA_ARGS__, Signature>
+
+/**
+ * Explicitly instantiates the evaluation declared by
+ * `CTAEB_EXTERN_EVALUATION`. Must be used in exactly one translation unit.
+ */
+#define CTAEB_INSTANTIATE_EVALUATION(Signature, ...) \
+    template struct ctaeb::Evaluation<__VA_ARGS__, Signature>
+
+#endif //CTAEB_EVALUATION_H
@@ -15,12 +15,109 @@
 #include <string>
 #include <functional>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "context.h"
+
+/**
+ * Set to 1 when the compiler supports C++20 concepts. In this mode the
+ * operators in `operations.h` are declared as constrained templates instead
+ * of SFINAE overload sets. Define `CTAEB_NO_CONCEPTS` to force the C++17 code
+ * path regardless of the language mode.
+ */
+#if !defined(CTAEB_NO_CONCEPTS) && defined(__cpp_concepts) && __cpp_concepts >= 201907L
+#define CTAEB_HAS_CONCEPTS 1
+#else
+#define CTAEB_HAS_CONCEPTS 0
+#endif
+
+/**
+ * Define `CTAEB_INSTRUMENTATION` to count evaluations, short-circuits, and
+ * cycles of every compound expression type; see `instrumentation.h`. All
+ * translation units of a program must agree on this setting.
+ */
+#ifdef CTAEB_INSTRUMENTATION
+#include "instrumentation.h"
+#endif
 
 /**
  * Defines expression classes: `Constant`, `Variable`, and `Compound`.
  */
 namespace ctaeb {
 
+namespace detail {
+
+/**
+ * Stands for an argument skipped by `select`; converts from anything.
+ */
+template<std::size_t>
+struct skip {
+    template<typename T>
+    constexpr skip(T &&) { // NOLINT
+    }
+};
+
+template<typename Indices>
+struct selector;
+
+template<std::size_t... I>
+struct selector<std::index_sequence<I...>> {
+    template<typename T, typename... Rest>
+    static constexpr T &&get(skip<I>..., T &&arg, Rest &&...) {
+        return std::forward<T>(arg);
+    }
+};
+
+/**
+ * Returns the argument with the index `N`. Unlike
+ * `std::get<N>(std::forward_as_tuple(args...))`, this doesn't instantiate
+ * a tuple type for every list of argument types: the skipped arguments
+ * bind to the parameters `skip<I>...` of a function that is shared by all
+ * the calls with the same `N`.
+ */
+template<std::size_t N, typename... Args>
+constexpr decltype(auto) select(Args &&... args) {
+    return selector<std::make_index_sequence<N>>::get(std::forward<Args>(args)...);
+}
+
+template<typename E, typename Tuple, std::size_t... I>
+decltype(auto) apply_tuple(const E &expr, Tuple &args, std::index_sequence<I...>) {
+    using std::get;
+    return expr(get<I>(args)...);
+}
+
+/**
+ * Evaluates `expr` with the elements of `args` as the values of
+ * the variables; see `Compound::apply`.
+ */
+template<typename E, typename Tuple>
+decltype(auto) apply_tuple(const E &expr, Tuple &args) {
+    return apply_tuple(expr, args, std::make_index_sequence<std::tuple_size<std::remove_const_t<Tuple>>::value>());
+}
+
+/**
+ * The end of a chain of `Scope`s.
+ */
+struct NoScope {
+};
+
+inline constexpr NoScope no_scope{};
+
+/**
+ * The value of `Local<N>` bound by a `Let`, followed by the values bound by
+ * the enclosing `Let`s. A scope is passed to the body of a `Let` before
+ * the values of the variables (after the `Context`, if there is one), and
+ * variables skip it like they skip the context.
+ */
+template<std::size_t N, typename T, typename Outer>
+struct Scope {
+    const T &value;
+    const Outer &outer;
+};
+
+} //::detail
+
 /**
  * Represents a constant value. Holds an immutable value of type `T`. Every
  * time a sub-expression appears in a compound expression that is not a variable
@@ -56,6 +153,14 @@ class Constant {
         return value_;
     }
 
+    /**
+     * Same as `operator()`, with the arguments given as a tuple.
+     */
+    template <typename Tuple>
+    const T &apply(const Tuple &) const {
+        return value_;
+    }
+
     /**
      * Stored constant value.
      */
@@ -115,7 +220,37 @@ class Variable {
     decltype(auto) operator()(Args &&... args) const {
         // this will not compile if not enough arguments are given
         // to an expression that contains the variable
-        return std::get<N - 1>(std::forward_as_tuple(args...));
+        return detail::select<N - 1>(args...);
+    }
+
+    /**
+     * Same as above; the evaluation context is not a value of a variable.
+     */
+    template <typename... Args>
+    decltype(auto) operator()(Context &, Args &&... args) const {
+        return detail::select<N - 1>(args...);
+    }
+
+    /**
+     * Same as above; the values bound by `let` are not values of variables.
+     */
+    template <std::size_t M, typename T, typename Outer, typename... Args>
+    decltype(auto) operator()(detail::Scope<M, T, Outer> &, Args &&... args) const {
+        return detail::select<N - 1>(args...);
+    }
+
+    template <std::size_t M, typename T, typename Outer, typename... Args>
+    decltype(auto) operator()(Context &, detail::Scope<M, T, Outer> &, Args &&... args) const {
+        return detail::select<N - 1>(args...);
+    }
+
+    /**
+     * Same as `operator()`, with the arguments given as a tuple.
+     */
+    template <typename Tuple>
+    decltype(auto) apply(Tuple &&args) const {
+        using std::get;
+        return get<N - 1>(args);
     }
 
   private:
@@ -172,9 +307,27 @@ class Compound {
 
     template <typename ...Args>
     decltype(auto) operator()(Args&&... args) const {
+#ifdef CTAEB_INSTRUMENTATION
+        instrumentation::Probe<Compound> probe;
+#endif
         return invoker_(expressions_, std::forward<Args>(args)...);
     }
 
+    /**
+     * Evaluates the expression with the elements of `args` as the values of
+     * the variables. `args` may be @em std::tuple, @em std::pair,
+     * @em std::array, or a user-defined type for which @em std::tuple_size
+     * and `get` are defined:
+     * @code
+     * std::tuple<int, int> args(1, 2);
+     * int sum = (x + y).apply(args);
+     * @endcode
+     */
+    template <typename Tuple>
+    decltype(auto) apply(Tuple &&args) const {
+        return detail::apply_tuple(*this, args);
+    }
+
   private:
 
     // defined in print.h
@@ -192,6 +345,36 @@ class Compound {
     detail::Invoker<Op> invoker_;
 };
 
+/**
+ * Tells whether the operation `Op` is lazy. The operands of a lazy operation
+ * are not evaluated before the operation is applied; instead, it receives
+ * a thunk per operand, a function object without parameters that evaluates
+ * the operand and returns its value. The operation decides which operands
+ * to evaluate, and may evaluate an operand more than once. An operation is
+ * lazy if it defines a static member @em lazy that is @em true:
+ * @code
+ * template<typename T = void>
+ * struct coalesce {
+ *     static constexpr bool lazy = true;
+ *
+ *     template<typename F1, typename F2>
+ *     auto operator()(const F1 &value1, const F2 &value2) const {
+ *         auto value = value1();
+ *         return value ? *value : value2();
+ *     }
+ * };
+ * @endcode
+ * Operations that can't be changed are made lazy by specializing this
+ * template.
+ */
+template<template<typename...> typename Op, typename = void>
+struct is_lazy_operation : std::false_type {
+};
+
+template<template<typename...> typename Op>
+struct is_lazy_operation<Op, std::enable_if_t<Op<void>::lazy>> : std::true_type {
+};
+
 namespace detail {
 
 /**
@@ -213,16 +396,48 @@ class Invoker {
         //);
     }
 
+    template <typename Tuple, typename... Args, std::size_t... I>
+    decltype(auto) eval(const Tuple &tuple, std::index_sequence<I...>, Context &context,
+                        Args&&... args) const {
+        return invoke_in(context, op, std::get<I>(tuple)(context, std::forward<Args>(args)...)...);
+    }
+
+    /**
+     * Same as `eval`, but passes thunks that evaluate the nested expressions
+     * instead of their values; see `is_lazy_operation`.
+     */
+    template <typename Tuple, typename... Args, std::size_t... I>
+    decltype(auto) eval_lazy(const Tuple &tuple, std::index_sequence<I...>, Args&&... args) const {
+        return op([&tuple, &args...]() -> decltype(auto) {
+            return std::get<I>(tuple)(args...);
+        }...);
+    }
+
+    template <typename Tuple, typename... Args, std::size_t... I>
+    decltype(auto) eval_lazy(const Tuple &tuple, std::index_sequence<I...>, Context &context,
+                             Args&&... args) const {
+        return invoke_in(context, op, [&tuple, &context, &args...]() -> decltype(auto) {
+            return std::get<I>(tuple)(context, args...);
+        }...);
+    }
+
   public:
     /**
      * Applies evaluation to the nested expressions, and then applies the
      * compound's operation on the resulting tuple. The process recurs
      * from the compounds down to variables and constants. This is the reason
-     * for all expression types to implement `operator()`.
+     * for all expression types to implement `operator()`. Lazy operations
+     * get thunks instead of the results; see `is_lazy_operation`.
      */
     template <typename Tuple, typename ...Args>
     decltype(auto) operator()(const Tuple &tuple, Args &&... args) const {
-        return eval(tuple, std::make_index_sequence<std::tuple_size<Tuple>::value>(), std::forward<Args>(args)...);
+        if constexpr (is_lazy_operation<Operation>::value) {
+            return eval_lazy(tuple, std::make_index_sequence<std::tuple_size<Tuple>::value>(),
+                             std::forward<Args>(args)...);
+        } else {
+            return eval(tuple, std::make_index_sequence<std::tuple_size<Tuple>::value>(),
+                        std::forward<Args>(args)...);
+        }
     }
 };
 
@@ -251,6 +466,10 @@ class Invoker<std::logical_and> {
     decltype(auto) operator()(const std::tuple<T1, T2> &tuple, Args &&... args) const {
         auto res1 = std::get<0>(tuple)(std::forward<Args>(args)...);
         if (!res1) {
+#ifdef CTAEB_INSTRUMENTATION
+            instrumentation::counters<Compound<std::logical_and, T1, T2>>()
+                .record_short_circuit();
+#endif
             return false;
         }
         auto res2 = std::get<1>(tuple)(std::forward<Args>(args)...);
@@ -284,6 +503,10 @@ class Invoker<std::logical_or> {
     decltype(auto) operator()(const std::tuple<T1, T2> &tuple, Args &&... args) const {
         auto res1 = std::get<0>(tuple)(std::forward<Args>(args)...);
         if (res1) {
+#ifdef CTAEB_INSTRUMENTATION
+            instrumentation::counters<Compound<std::logical_or, T1, T2>>()
+                .record_short_circuit();
+#endif
             return true;
         }
         auto res2 = std::get<1>(tuple)(std::forward<Args>(args)...);
@@ -316,14 +539,71 @@ template<template<typename...> typename Op, typename ...Args>
 struct is_compound<ctaeb::Compound<Op, Args...>> : std::true_type {
 };
 
+// specialized in table.h
+template<typename>
+struct is_table : std::false_type {
+};
+
+// specialized in let.h
+template<typename>
+struct is_let : std::false_type {
+};
+
 template <typename T>
 struct is_expression : std::disjunction<is_variable<T>,
                                         is_constant<T>,
-                                        is_compound<T>> {
+                                        is_compound<T>,
+                                        is_table<T>,
+                                        is_let<T>> {
 };
 
+#if CTAEB_HAS_CONCEPTS
+/**
+ * Same as `is_expression`, but answered by a single partial specialization
+ * lookup instead of a disjunction of three traits.
+ */
+template<typename>
+inline constexpr bool is_expression_v = false;
+
+template<std::size_t N>
+inline constexpr bool is_expression_v<ctaeb::Variable<N>> = true;
+
+template<typename T>
+inline constexpr bool is_expression_v<ctaeb::Constant<T>> = true;
+
+template<template<typename...> typename Op, typename ...Args>
+inline constexpr bool is_expression_v<ctaeb::Compound<Op, Args...>> = true;
+#endif
+
 } //::detail
 
+#if CTAEB_HAS_CONCEPTS
+/**
+ * Satisfied by `Constant`, `Variable`, and `Compound`, regardless of
+ * cv-qualification and value category.
+ */
+template<typename T>
+concept expression = detail::is_expression_v<std::remove_cvref_t<T>>;
+
+/**
+ * Satisfied when at least one of the operands is an expression; this is
+ * the requirement of every binary operator in `operations.h`.
+ */
+template<typename T1, typename T2>
+concept expression_operands = expression<T1> || expression<T2>;
+
+namespace detail {
+
+/**
+ * Maps an operand type to the type stored in a `Compound`: expressions
+ * are kept as is, any other value is wrapped into `Constant`.
+ */
+template<typename T>
+using operand_t = std::conditional_t<expression<T>, T, Constant<T>>;
+
+} //::detail
+#endif
+
 template<typename T>
 using Expression = std::enable_if_t<detail::is_expression<std::decay_t<T>>::value>;
 
@@ -335,6 +615,27 @@ using Expressions = std::enable_if_t<
     detail::is_expression<std::decay_t<E1>>::value && detail::is_expression<std::decay_t<E2>>::value
 >;
 
+/**
+ * Enables functions that build a `Compound` from any mix of expressions and
+ * values, as long as at least one of the arguments is an expression.
+ */
+template<typename... T>
+using AnyExpression = std::enable_if_t<
+    std::disjunction<detail::is_expression<std::decay_t<T>>...>::value
+>;
+
+namespace detail {
+
+/**
+ * Maps an argument of such a function to the type stored in the `Compound`:
+ * expressions are kept as is, any other value is wrapped into `Constant`.
+ */
+template<typename T>
+using stored_operand_t = std::conditional_t<is_expression<std::decay_t<T>>::value,
+                                            T, Constant<T>>;
+
+} //::detail
+
 } //::ctaeb
 
 #endif //CTAEB_EXPRESSION_H
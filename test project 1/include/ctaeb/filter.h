@@ -0,0 +1,161 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `filter`, which evaluates a predicate over columns of values
+ * and returns the matching rows.
+ */
+
+#ifndef CTAEB_FILTER_H
+#define CTAEB_FILTER_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "expression.h"
+#include "adaptive.h"
+#include "cost.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+/**
+ * Rows are filtered in blocks of this size, so that the selection of a block
+ * stays in the cache while the conjuncts are applied to it.
+ */
+constexpr std::size_t filter_block_size = 1024;
+
+/**
+ * Writes the indices of the rows in `[begin, end)` that match `expr` into
+ * `selection`; returns their number. Every row index is written, and the
+ * output position advances only for matching rows, so there's no branch
+ * that depends on the data.
+ */
+template<typename E, typename... Columns>
+std::size_t select_rows(const E &expr, std::size_t begin, std::size_t end,
+                        std::size_t *selection, const Columns &... columns) {
+    std::size_t count = 0;
+    for (std::size_t row = begin; row < end; ++row) {
+        selection[count] = row;
+        count += static_cast<bool>(expr(columns[row]...));
+    }
+    return count;
+}
+
+/**
+ * Same as `select_rows`, but only the rows in `selection` are evaluated.
+ */
+template<typename E, typename... Columns>
+std::size_t refine_rows(const E &expr, std::size_t *selection, std::size_t size,
+                        const Columns &... columns) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        std::size_t row = selection[i];
+        selection[count] = row;
+        count += static_cast<bool>(expr(columns[row]...));
+    }
+    return count;
+}
+
+/**
+ * Applies the conjunct `First` to all the rows of a block, and each of
+ * the conjuncts `I...` to the rows selected by the previous conjuncts.
+ */
+template<typename Conjuncts, std::size_t First, std::size_t... I, typename... Columns>
+std::size_t filter_block(const Conjuncts &conjuncts, std::index_sequence<First, I...>,
+                         std::size_t begin, std::size_t end,
+                         std::size_t *selection, const Columns &... columns) {
+    std::size_t count = select_rows(std::get<First>(conjuncts), begin, end, selection, columns...);
+    auto _ = {count, (count = refine_rows(std::get<I>(conjuncts), selection, count, columns...))...};
+    static_cast<void>(_);
+    return count;
+}
+
+/**
+ * Calls `consume(selection, count)` for every block of rows, where
+ * `selection` holds the indices of the `count` matching rows of the block.
+ */
+template<typename E, typename Consumer, typename First, typename... Columns>
+void filter_blocks(const E &predicate, Consumer consume,
+                   const First &first, const Columns &... columns) {
+    using Chain = chain_operands<std::logical_and, E>;
+    using Conjuncts = typename Chain::type;
+    using Order = typename cost_order<Conjuncts, decltype(first[0]),
+                                      decltype(columns[0])...>::type;
+
+    const Conjuncts conjuncts = Chain::get(predicate);
+    const std::size_t rows = first.size();
+    std::array<std::size_t, filter_block_size> selection;
+    for (std::size_t begin = 0; begin < rows; begin += filter_block_size) {
+        std::size_t end = std::min(begin + filter_block_size, rows);
+        std::size_t count = filter_block(conjuncts, Order(), begin, end, selection.data(),
+                                         first, columns...);
+        consume(selection.data(), count);
+    }
+}
+
+} //::detail
+
+/**
+ * Evaluates `predicate` for every row of the given columns and returns
+ * the indices of the rows for which it's @em true, in ascending order.
+ * Column `N - 1` gives the values of `Variable<N>`; a column is anything
+ * that has `size()` and `operator[]`, and all the columns must have the same
+ * size.
+ *
+ * If the predicate is a chain `a && b && ...`, the conjuncts are applied
+ * one at a time to blocks of rows: `a` to all the rows of a block, `b` only
+ * to the rows selected by `a`, and so on. This is the batch counterpart of
+ * short-circuit evaluation; pure conjuncts are applied the cheapest first
+ * (see `expression_cost`). The loops over rows don't branch on the values;
+ * a conjunct may still contain its own @em && and @em ||, which are
+ * evaluated as usual.
+ * @code
+ * std::vector<int> x = {1, 7, 3, 4};
+ * std::vector<int> y = {0, 1, 2, 0};
+ * auto rows = filter(Variable<1>() < 5 && Variable<2>() != 0, x, y);
+ * // rows == {2}
+ * @endcode
+ */
+template<typename E, typename First, typename... Columns, typename = Expression<E>>
+std::vector<std::size_t> filter(const E &predicate, const First &first,
+                                const Columns &... columns) {
+    assert(((columns.size() == first.size()) && ...));
+    std::vector<std::size_t> result;
+    detail::filter_blocks(predicate, [&result](const std::size_t *selection, std::size_t count) {
+        result.insert(result.end(), selection, selection + count);
+    }, first, columns...);
+    return result;
+}
+
+/**
+ * Same as `filter`, but returns a bitmap in which the bit `i % 64` of
+ * the word `i / 64` is set if the row `i` matches the predicate.
+ */
+template<typename E, typename First, typename... Columns, typename = Expression<E>>
+std::vector<std::uint64_t> filter_bitmap(const E &predicate, const First &first,
+                                         const Columns &... columns) {
+    assert(((columns.size() == first.size()) && ...));
+    std::vector<std::uint64_t> result((first.size() + 63) / 64, 0);
+    detail::filter_blocks(predicate, [&result](const std::size_t *selection, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            result[selection[i] / 64] |= std::uint64_t(1) << (selection[i] % 64);
+        }
+    }, first, columns...);
+    return result;
+}
+
+} //::ctaeb
+
+#endif //CTAEB_FILTER_H
@@ -0,0 +1,127 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `to_function_pointer`, which converts an expression into
+ * a plain function pointer.
+ */
+
+#ifndef CTAEB_FUNCTION_POINTER_H
+#define CTAEB_FUNCTION_POINTER_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+#include "rewrite.h"
+
+namespace ctaeb {
+
+template<typename Signature>
+struct BoundFunction;
+
+/**
+ * A function pointer with a context pointer, in the form that C APIs take
+ * callbacks: `fn(ctx, args...)` evaluates the expression that `ctx` points
+ * to. The expression is not copied and must outlive the `BoundFunction`.
+ */
+template<typename R, typename... Args>
+struct BoundFunction<R(Args...)> {
+    R (*fn)(void *, Args...);
+    void *ctx;
+
+    R operator()(Args... args) const {
+        return fn(ctx, args...);
+    }
+};
+
+namespace detail {
+
+/**
+ * An empty function object that evaluates the same way as an expression
+ * of the type `T`, which consists of variables and compounds of them.
+ */
+template<typename T>
+struct stateless;
+
+template<std::size_t N>
+struct stateless<Variable<N>> {
+    template<typename... Args>
+    decltype(auto) operator()(Args &&... args) const {
+        return detail::select<N - 1>(args...);
+    }
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct stateless<Compound<Op, Nested...>> {
+    template<typename... Args>
+    decltype(auto) operator()(Args &&... args) const {
+        return Invoker<Op>()(std::tuple<stateless<Nested>...>(), std::forward<Args>(args)...);
+    }
+};
+
+template<typename E, typename R, typename... Args>
+R call_stateless(Args... args) {
+    return static_cast<R>(stateless<E>()(args...));
+}
+
+template<typename E, typename R, typename... Args>
+R call_bound(void *context, Args... args) {
+    return static_cast<R>((*static_cast<const E *>(context))(args...));
+}
+
+template<typename E, typename Signature>
+struct function_pointer;
+
+template<typename E, typename R, typename... Args>
+struct function_pointer<E, R(Args...)> {
+    static constexpr bool stateless = is_value_free<canonical_t<E>>::value;
+
+    static auto get(const E &expr) {
+        if constexpr (stateless) {
+            static_cast<void>(expr);
+            return &call_stateless<canonical_t<E>, R, Args...>;
+        } else {
+            return BoundFunction<R(Args...)>{&call_bound<E, R, Args...>,
+                                             const_cast<void *>(static_cast<const void *>(&expr))};
+        }
+    }
+};
+
+} //::detail
+
+/**
+ * Converts the expression into a function of the signature `Signature`,
+ * such as `int(int, int)`, which passes its arguments to the expression
+ * and converts the result to its return type. An expression of variables
+ * and operations only has no state, and becomes a plain function pointer:
+ * @code
+ * Variable<1> x("x");
+ * Variable<2> y("y");
+ * int (*max)(int, int) = to_function_pointer<int(int, int)>(select(x < y, y, x));
+ * @endcode
+ * An expression that holds constants becomes a `BoundFunction`, a pointer
+ * to a function that takes a pointer to the expression as its first
+ * argument, and the pointer to the expression; in this case `expr` must
+ * not be a temporary, and must outlive the result. Unlike `std::function`,
+ * neither of them allocates memory, and a call is one indirect call
+ * of a function in which the expression is inlined.
+ */
+template<typename Signature, typename E, typename = Expression<E>>
+auto to_function_pointer(E &&expr) {
+    using Pointer = detail::function_pointer<std::decay_t<E>, Signature>;
+    static_assert(Pointer::stateless || std::is_lvalue_reference<E>::value,
+                  "ctaeb::to_function_pointer: the expression has state, and a pointer "
+                  "to it would outlive it; pass an expression that is not a temporary");
+    return Pointer::get(expr);
+}
+
+} //::ctaeb
+
+#endif //CTAEB_FUNCTION_POINTER_H
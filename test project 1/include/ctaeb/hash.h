@@ -0,0 +1,201 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines structural hashing and equality of expressions.
+ */
+
+#ifndef CTAEB_HASH_H
+#define CTAEB_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+#include "serialize.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+constexpr std::uint64_t hash_combine(std::uint64_t seed, std::uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+constexpr std::uint64_t hash_string(std::string_view str) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : str) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Hash of the structure of the canonical expression type `T`: the kinds of
+ * the nodes, the operations, the variable indices, and the types of
+ * the constants.
+ */
+template<typename T>
+struct structure_hash;
+
+template<std::size_t N>
+struct structure_hash<Variable<N>> {
+    static constexpr std::uint64_t value = hash_combine(1, N);
+};
+
+template<typename T>
+struct structure_hash<Constant<T>> {
+    static constexpr std::uint64_t value = hash_combine(2, hash_string(type_signature<T>()));
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct structure_hash<Compound<Op, Nested...>> {
+    static constexpr std::uint64_t value = [] {
+        std::uint64_t seed = hash_combine(3, operation_id<Op>::value);
+        for (std::uint64_t nested : {structure_hash<Nested>::value...}) {
+            seed = hash_combine(seed, nested);
+        }
+        return seed;
+    }();
+};
+
+template<typename T, typename = void>
+struct is_hashable : std::false_type {
+};
+
+template<typename T>
+struct is_hashable<T, std::void_t<decltype(std::hash<T>()(std::declval<const T &>()))>>
+    : std::true_type {
+};
+
+template<std::size_t N>
+std::uint64_t hash_values(std::uint64_t seed, const Variable<N> &) {
+    return seed;
+}
+
+/**
+ * Values of the types that have no @em std::hash specialization are
+ * skipped; such constants affect only `structurally_equal`.
+ */
+template<typename T>
+std::uint64_t hash_values(std::uint64_t seed, const Constant<T> &expr) {
+    using Value = std::decay_t<T>;
+    if constexpr (is_hashable<Value>::value) {
+        return hash_combine(seed, std::hash<Value>()(expr()));
+    } else {
+        return seed;
+    }
+}
+
+template<template<typename...> typename Op, typename... Nested>
+std::uint64_t hash_values(std::uint64_t seed, const Compound<Op, Nested...> &expr) {
+    std::apply([&seed](const auto &... nested) {
+        auto _ = {0, (seed = hash_values(seed, nested), 0)...};
+        static_cast<void>(_);
+    }, expr.get_expressions());
+    return seed;
+}
+
+template<std::size_t N>
+bool equal_values(const Variable<N> &, const Variable<N> &) {
+    return true;
+}
+
+template<typename T1, typename T2>
+bool equal_values(const Constant<T1> &expr1, const Constant<T2> &expr2) {
+    return static_cast<bool>(expr1() == expr2());
+}
+
+template<template<typename...> typename Op, typename... Nested1, typename... Nested2>
+bool equal_values(const Compound<Op, Nested1...> &expr1,
+                  const Compound<Op, Nested2...> &expr2);
+
+template<template<typename...> typename Op, typename... Nested1, typename... Nested2,
+         std::size_t... I>
+bool equal_values(const Compound<Op, Nested1...> &expr1,
+                  const Compound<Op, Nested2...> &expr2,
+                  std::index_sequence<I...>) {
+    return (equal_values(std::get<I>(expr1.get_expressions()),
+                         std::get<I>(expr2.get_expressions())) && ...);
+}
+
+template<template<typename...> typename Op, typename... Nested1, typename... Nested2>
+bool equal_values(const Compound<Op, Nested1...> &expr1,
+                  const Compound<Op, Nested2...> &expr2) {
+    return equal_values(expr1, expr2, std::index_sequence_for<Nested1...>());
+}
+
+} //::detail
+
+/**
+ * Hash of the structure of the expression type `E`, available at compile
+ * time. Expressions with the same `canonical_t` have the same structure
+ * hash. Operations are identified by `operation_id`, thus the value is
+ * the same in all programs built by one compiler.
+ */
+template<typename E>
+constexpr std::size_t structure_hash_v =
+    static_cast<std::size_t>(detail::structure_hash<canonical_t<E>>::value);
+
+/**
+ * Returns the hash of `expr`, which combines `structure_hash_v<E>` with
+ * the hashes of the constants' values. Variable names are not a part of
+ * the structure, because they don't affect evaluation. Expressions for which
+ * `structurally_equal` is @em true have the same hash.
+ */
+template<typename E, typename = Expression<E>>
+std::size_t hash(const E &expr) {
+    return static_cast<std::size_t>(
+        detail::hash_values(detail::structure_hash<canonical_t<E>>::value, expr));
+}
+
+/**
+ * Tells whether the expressions have the same structure (see
+ * `structure_hash_v`) and equal constants. Whether the structures match is
+ * known at compile time, so expressions of different canonical types are
+ * compared without evaluating anything. Operands are compared in the order
+ * they were written; to compare expressions that differ only in the order of
+ * commutative operands, `normalize` them first.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+bool structurally_equal(const E1 &expr1, const E2 &expr2) {
+    if constexpr (std::is_same<canonical_t<E1>, canonical_t<E2>>::value) {
+        return detail::equal_values(expr1, expr2);
+    } else {
+        return false;
+    }
+}
+
+/**
+ * Function object that calls `hash`; may be used as the hash of unordered
+ * containers of expressions.
+ */
+struct ExpressionHash {
+    template<typename E>
+    std::size_t operator()(const E &expr) const {
+        return hash(expr);
+    }
+};
+
+/**
+ * Function object that calls `structurally_equal`.
+ */
+struct StructurallyEqual {
+    template<typename E1, typename E2>
+    bool operator()(const E1 &expr1, const E2 &expr2) const {
+        return structurally_equal(expr1, expr2);
+    }
+};
+
+} //::ctaeb
+
+#endif //CTAEB_HASH_H
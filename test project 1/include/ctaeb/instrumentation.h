@@ -0,0 +1,169 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines evaluation counters of compound expressions. The counters
+ * are updated only if `CTAEB_INSTRUMENTATION` is defined; otherwise this
+ * header is not included, and evaluation code is the same as without it.
+ */
+
+#ifndef CTAEB_INSTRUMENTATION_H
+#define CTAEB_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace ctaeb {
+
+/**
+ * Provides evaluation counters of compound expressions.
+ */
+namespace instrumentation {
+
+/**
+ * Totals of a node's counters; see `counters`.
+ */
+struct Totals {
+    /**
+     * The number of evaluations.
+     */
+    std::uint64_t calls;
+
+    /**
+     * The number of evaluations of @em && and @em || nodes that didn't need
+     * the second operand.
+     */
+    std::uint64_t short_circuits;
+
+    /**
+     * Cycles (or clock ticks where cycles aren't available) spent in the node,
+     * including its sub-expressions.
+     */
+    std::uint64_t cycles;
+};
+
+/**
+ * Counters of one expression type. Threads update different cache lines
+ * (shards) with relaxed atomic increments, so updates neither lock nor
+ * contend unless there are more threads than shards.
+ */
+class Counters {
+  public:
+    static constexpr std::size_t shard_count = 16;
+
+    void record_call(std::uint64_t cycles) {
+        auto &s = shard();
+        s.calls.fetch_add(1, std::memory_order_relaxed);
+        s.cycles.fetch_add(cycles, std::memory_order_relaxed);
+    }
+
+    void record_short_circuit() {
+        shard().short_circuits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Sums the counters of all the shards. The result is exact once
+     * the evaluations that are being counted have finished.
+     */
+    Totals totals() const {
+        Totals result{0, 0, 0};
+        for (const auto &s : shards_) {
+            result.calls += s.calls.load(std::memory_order_relaxed);
+            result.short_circuits += s.short_circuits.load(std::memory_order_relaxed);
+            result.cycles += s.cycles.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    void reset() {
+        for (auto &s : shards_) {
+            s.calls.store(0, std::memory_order_relaxed);
+            s.short_circuits.store(0, std::memory_order_relaxed);
+            s.cycles.store(0, std::memory_order_relaxed);
+        }
+    }
+
+  private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> short_circuits{0};
+        std::atomic<std::uint64_t> cycles{0};
+    };
+
+    /**
+     * Threads are assigned to shards round-robin when they first record
+     * anything.
+     */
+    Shard &shard() {
+        static std::atomic<std::size_t> next_shard{0};
+        thread_local std::size_t index =
+            next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+        return shards_[index];
+    }
+
+    std::array<Shard, shard_count> shards_;
+};
+
+/**
+ * Returns the counters of the expression type `E`. All the nodes of
+ * the same type share their counters, thus identical sub-expressions are
+ * counted together.
+ */
+template<typename E>
+Counters &counters() {
+    static Counters instance;
+    return instance;
+}
+
+/**
+ * Reads the time stamp counter on x86, the steady clock elsewhere.
+ */
+inline std::uint64_t clock() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * Counts one evaluation of `E` and the cycles spent in it, from construction
+ * till destruction.
+ */
+template<typename E>
+class Probe {
+  public:
+    Probe() : start_(clock()) {
+    }
+
+    Probe(const Probe &) = delete;
+    Probe &operator=(const Probe &) = delete;
+
+    ~Probe() {
+        counters<E>().record_call(clock() - start_);
+    }
+
+  private:
+    std::uint64_t start_;
+};
+
+} //::instrumentation
+
+} //::ctaeb
+
+#endif //CTAEB_INSTRUMENTATION_H
@@ -0,0 +1,228 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `let`, which evaluates a sub-expression once and uses its
+ * value several times.
+ */
+
+#ifndef CTAEB_LET_H
+#define CTAEB_LET_H
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+
+namespace ctaeb {
+
+template<std::size_t N, typename E>
+struct Bind;
+
+namespace detail {
+
+template<std::size_t N>
+void lookup(const NoScope &) {
+    static_assert(N != N, "ctaeb::Local: the local is not bound by an enclosing let");
+}
+
+/**
+ * Returns the value of `Local<N>` from the innermost scope that binds it.
+ */
+template<std::size_t N, std::size_t M, typename T, typename Outer>
+const auto &lookup(const Scope<M, T, Outer> &scope) {
+    if constexpr (N == M) {
+        return scope.value;
+    } else {
+        return lookup<N>(scope.outer);
+    }
+}
+
+} //::detail
+
+/**
+ * A name for the value of a sub-expression, introduced by `let`. Like
+ * `Variable<N>`, a local is identified by its index `N`, and has an optional
+ * name that is used for printing. An inner `let` that binds the same index
+ * hides the outer one.
+ */
+template<std::size_t N>
+class Local {
+  public:
+    /**
+     * Constructs a nameless local.
+     */
+    Local() : name_(std::string("t") + std::to_string(N)) {
+    }
+
+    /**
+     * Constructs a named local.
+     */
+    explicit Local(const char *name) : name_(name) {
+    }
+
+    /**
+     * Constructs a named local.
+     */
+    explicit Local(const std::string &name) : name_(name) {
+    }
+
+    const std::string &name() const {
+        return name_;
+    }
+
+    /**
+     * Binds the local to `expr`; the result is the first argument of `let`.
+     */
+    template<typename E, typename = Expression<E>>
+    Bind<N, E> operator=(E &&expr) const { // NOLINT
+        return Bind<N, E>{*this, std::forward<E>(expr)};
+    }
+
+    /**
+     * Returns the value bound by the innermost enclosing `let`.
+     */
+    template<std::size_t M, typename T, typename Outer, typename... Args>
+    const auto &operator()(detail::Scope<M, T, Outer> &scope, Args &&...) const {
+        return detail::lookup<N>(scope);
+    }
+
+    template<std::size_t M, typename T, typename Outer, typename... Args>
+    const auto &operator()(Context &, detail::Scope<M, T, Outer> &scope, Args &&...) const {
+        return detail::lookup<N>(scope);
+    }
+
+    template<typename... Args>
+    void operator()(Args &&...) const {
+        static_assert(sizeof...(Args) != sizeof...(Args),
+                      "ctaeb::Local: evaluated outside of the let that binds it");
+    }
+
+  private:
+    std::string name_;
+};
+
+/**
+ * A local bound to an expression: `t = a + b`.
+ */
+template<std::size_t N, typename E>
+struct Bind {
+    Local<N> local;
+    E expr;
+};
+
+namespace detail {
+
+/**
+ * Evaluates `body` with `value` bound to `Local<N>`. The overloads keep
+ * the context first and chain the new scope to the enclosing one.
+ */
+template<std::size_t N, typename E, typename T, typename... Args>
+auto bind_scope(const E &body, const T &value, Args &... args) {
+    Scope<N, T, NoScope> scope{value, no_scope};
+    return body(scope, args...);
+}
+
+template<std::size_t N, typename E, typename T,
+         std::size_t M, typename U, typename Outer, typename... Args>
+auto bind_scope(const E &body, const T &value, Scope<M, U, Outer> &outer, Args &... args) {
+    Scope<N, T, Scope<M, U, Outer>> scope{value, outer};
+    return body(scope, args...);
+}
+
+template<std::size_t N, typename E, typename T, typename... Args>
+auto bind_scope(const E &body, const T &value, Context &context, Args &... args) {
+    Scope<N, T, NoScope> scope{value, no_scope};
+    return body(context, scope, args...);
+}
+
+template<std::size_t N, typename E, typename T,
+         std::size_t M, typename U, typename Outer, typename... Args>
+auto bind_scope(const E &body, const T &value, Context &context,
+                Scope<M, U, Outer> &outer, Args &... args) {
+    Scope<N, T, Scope<M, U, Outer>> scope{value, outer};
+    return body(context, scope, args...);
+}
+
+} //::detail
+
+/**
+ * Evaluates `Bound` once, and then `Body`, in which every `Local<N>` stands
+ * for the value of `Bound`. Unlike a sub-expression that appears in several
+ * places of an expression, the bound one is evaluated once per evaluation
+ * of the `Let`, no matter how many times the local is used. The result is
+ * returned by value, because it may refer to the bound value, which exists
+ * only during the evaluation.
+ */
+template<std::size_t N, typename Bound, typename Body>
+class Let {
+  public:
+    Let(const Local<N> &local, const Bound &bound, const Body &body)
+        : local_(local), bound_(bound), body_(body) {
+    }
+
+    const Local<N> &local() const {
+        return local_;
+    }
+
+    const std::decay_t<Bound> &bound() const {
+        return bound_;
+    }
+
+    const std::decay_t<Body> &body() const {
+        return body_;
+    }
+
+    template<typename... Args>
+    auto operator()(Args &&... args) const {
+        const auto &value = bound_(args...);
+        return detail::bind_scope<N>(body_, value, args...);
+    }
+
+  private:
+    Local<N> local_;
+    Bound bound_;
+    Body body_;
+};
+
+/**
+ * Creates a `Let` expression:
+ * @code
+ * Local<1> t("t");
+ * auto e = let(t = a + b, t * t - t);
+ * @endcode
+ * is `(a + b) * (a + b) - (a + b)` with the sum computed once.
+ */
+template<std::size_t N, typename E, typename Body, typename = Expression<Body>>
+Let<N, E, Body> let(const Bind<N, E> &binding, Body &&body) {
+    return Let<N, E, Body>(binding.local, binding.expr, std::forward<Body>(body));
+}
+
+namespace detail {
+
+template<std::size_t N>
+struct is_let<ctaeb::Local<N>> : std::true_type {
+};
+
+template<std::size_t N, typename Bound, typename Body>
+struct is_let<ctaeb::Let<N, Bound, Body>> : std::true_type {
+};
+
+#if CTAEB_HAS_CONCEPTS
+template<std::size_t N>
+inline constexpr bool is_expression_v<ctaeb::Local<N>> = true;
+
+template<std::size_t N, typename Bound, typename Body>
+inline constexpr bool is_expression_v<ctaeb::Let<N, Bound, Body>> = true;
+#endif
+
+} //::detail
+
+} //::ctaeb
+
+#endif //CTAEB_LET_H
@@ -0,0 +1,388 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines math function nodes: `sqrt`, `exp`, `log`, `pow`, `abs`,
+ * `min`, and `max`.
+ */
+
+#ifndef CTAEB_MATH_H
+#define CTAEB_MATH_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+#include "cost.h"
+
+/**
+ * Define `CTAEB_APPROXIMATE_MATH` to compute `exp` and `log` of @em float and
+ * @em double values with the polynomial kernels below instead of calling
+ * the C library. The kernels don't branch and don't call functions, so
+ * loops that evaluate an expression over columns of values vectorize; see
+ * `ctaeb::exponential` and `ctaeb::logarithm` for their accuracy. GCC
+ * vectorizes them with `-fno-trapping-math`, and the square root with
+ * `-fno-math-errno`; both are implied by `-ffast-math`. All translation
+ * units of a program should agree on this setting.
+ */
+#ifdef CTAEB_APPROXIMATE_MATH
+#define CTAEB_APPROXIMATE_MATH_ENABLED 1
+#else
+#define CTAEB_APPROXIMATE_MATH_ENABLED 0
+#endif
+
+namespace ctaeb {
+
+namespace detail {
+
+inline std::uint64_t to_bits(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double from_bits(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/**
+ * e<sup>x</sup>: `x = k ln2 + r` with `|r| <= ln2 / 2`, then
+ * e<sup>r</sup> by its Taylor polynomial of degree 13, scaled by
+ * 2<sup>k</sup> in two steps, so that the results that overflow or are
+ * subnormal come out of the last multiplication.
+ */
+inline double exp_kernel(double x) {
+    constexpr double log2e = 1.44269504088896338700e+00;
+    // ln2 split so that k * ln2_hi is exact
+    constexpr double ln2_hi = 6.93147180369123816490e-01;
+    constexpr double ln2_lo = 1.90821492927058770002e-10;
+    // adding this rounds to an integer, which ends up in the low bits
+    constexpr double shift = 0x1.8p52;
+
+    // the conditionals choose between values only, and nothing depends on
+    // them but the value, so that they compile to blends rather than jumps;
+    // NaN passes through
+    double clamped = x < -746.0 ? -746.0 : x;
+    clamped = clamped > 710.0 ? 710.0 : clamped;
+    double kd = clamped * log2e + shift;
+    auto k = static_cast<std::int64_t>(to_bits(kd) - to_bits(shift));
+    kd -= shift;
+    double r = (clamped - kd * ln2_hi) - kd * ln2_lo;
+
+    double p = 1.0 / 6227020800.0;
+    p = p * r + 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    // 1 + r + r^2 p, with the small terms summed first
+    p = 1.0 + (r + r * r * p);
+
+    // |k| <= 1077, thus both halves are valid exponents
+    std::int64_t k1 = k / 2;
+    std::int64_t k2 = k - k1;
+    double scale1 = from_bits(static_cast<std::uint64_t>(k1 + 1023) << 52);
+    double scale2 = from_bits(static_cast<std::uint64_t>(k2 + 1023) << 52);
+    return p * scale1 * scale2;
+}
+
+/**
+ * ln(x): `x = 2^e m` with `sqrt(1/2) <= m < sqrt(2)`, then
+ * `ln(m) = 2 atanh(s)`, `s = (m - 1) / (m + 1)`, by its series up to
+ * s<sup>19</sup>.
+ */
+inline double log_kernel(double x) {
+    constexpr double ln2_hi = 6.93147180369123816490e-01;
+    constexpr double ln2_lo = 1.90821492927058770002e-10;
+    constexpr double sqrt2 = 1.41421356237309504880e+00;
+    constexpr double min_normal = std::numeric_limits<double>::min();
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    // as in `exp_kernel`, the conditionals choose between values only;
+    // subnormals are scaled up into the normal range
+    bool subnormal = x < min_normal;
+    double y = x * (subnormal ? 0x1p54 : 1.0);
+    double bias = subnormal ? 1023.0 + 54.0 : 1023.0;
+    std::uint64_t bits = to_bits(y);
+    // the biased exponent, converted to double through the bits
+    double e = from_bits(0x4330000000000000 | (bits >> 52)) - 0x1p52 - bias;
+    double m = from_bits((bits & 0x000fffffffffffff) | 0x3ff0000000000000);
+    bool large = m > sqrt2;
+    e += large ? 1.0 : 0.0;
+    m *= large ? 0.5 : 1.0;
+
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double p = 2.0 / 19.0;
+    p = p * s2 + 2.0 / 17.0;
+    p = p * s2 + 2.0 / 15.0;
+    p = p * s2 + 2.0 / 13.0;
+    p = p * s2 + 2.0 / 11.0;
+    p = p * s2 + 2.0 / 9.0;
+    p = p * s2 + 2.0 / 7.0;
+    p = p * s2 + 2.0 / 5.0;
+    p = p * s2 + 2.0 / 3.0;
+    // 2s = f - f^2 / 2 + s f^2 / 2, which keeps the large term f exact
+    double f = m - 1.0;
+    double hfsq = 0.5 * f * f;
+    double result = e * ln2_hi - ((hfsq - (s * (hfsq + s2 * p) + e * ln2_lo)) - f);
+
+    // the result above is finite for any x; the special values are added
+    // to it: NaN for negative x and NaN, -inf for zero, inf for inf
+    double special = x < 0.0 ? std::numeric_limits<double>::quiet_NaN() : 0.0;
+    special = x == 0.0 ? -infinity : special;
+    special = x < infinity ? special : x;
+    return result + special;
+}
+
+template<typename X>
+constexpr bool approximate_math_v = CTAEB_APPROXIMATE_MATH_ENABLED &&
+    (std::is_same<X, double>::value || std::is_same<X, float>::value);
+
+} //::detail
+
+/**
+ * The square root, `sqrt(x)`.
+ */
+template<typename T = void>
+struct square_root {
+    static constexpr bool prefixed = true;
+
+    template<typename X>
+    auto operator()(const X &x) const {
+        using std::sqrt;
+        return sqrt(x);
+    }
+};
+
+/**
+ * The exponential function, `exp(x)`. With `CTAEB_APPROXIMATE_MATH`,
+ * the result for @em double is within 1 ulp of the exact value: the maximum
+ * error measured over 10<sup>8</sup> random arguments in [-708, 709.78] is
+ * 0.98 ulp. @em float is computed in @em double and rounded; the maximum
+ * measured error is 0.5 ulp.
+ */
+template<typename T = void>
+struct exponential {
+    static constexpr bool prefixed = true;
+
+    template<typename X>
+    auto operator()(const X &x) const {
+        if constexpr (detail::approximate_math_v<X>) {
+            return static_cast<X>(detail::exp_kernel(x));
+        } else {
+            using std::exp;
+            return exp(x);
+        }
+    }
+};
+
+/**
+ * The natural logarithm, `log(x)`. With `CTAEB_APPROXIMATE_MATH`,
+ * the result for @em double is within 1 ulp of the exact value: the maximum
+ * error measured over 10<sup>8</sup> random positive arguments and
+ * 10<sup>8</sup> arguments near 1 is 0.995 ulp. @em float is computed in
+ * @em double and rounded; the maximum measured error is 0.5 ulp.
+ */
+template<typename T = void>
+struct logarithm {
+    static constexpr bool prefixed = true;
+
+    template<typename X>
+    auto operator()(const X &x) const {
+        if constexpr (detail::approximate_math_v<X>) {
+            return static_cast<X>(detail::log_kernel(x));
+        } else {
+            using std::log;
+            return log(x);
+        }
+    }
+};
+
+/**
+ * `x` raised to the power `y`, `pow(x, y)`.
+ */
+template<typename T = void>
+struct power {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename Y>
+    auto operator()(const X &x, const Y &y) const {
+        using std::pow;
+        return pow(x, y);
+    }
+};
+
+/**
+ * The absolute value, `abs(x)`.
+ */
+template<typename T = void>
+struct absolute {
+    static constexpr bool prefixed = true;
+
+    template<typename X>
+    auto operator()(const X &x) const {
+        using std::abs;
+        return abs(x);
+    }
+};
+
+/**
+ * The smaller of two values, `min(x, y)`; `x` if they are equivalent.
+ * Like @em std::min, but the operands may have different types, and the
+ * result is a value of their common type.
+ */
+template<typename T = void>
+struct minimum {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename Y>
+    auto operator()(const X &x, const Y &y) const {
+        using R = std::common_type_t<X, Y>;
+        return y < x ? static_cast<R>(y) : static_cast<R>(x);
+    }
+};
+
+/**
+ * The larger of two values, `max(x, y)`; `x` if they are equivalent.
+ */
+template<typename T = void>
+struct maximum {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename Y>
+    auto operator()(const X &x, const Y &y) const {
+        using R = std::common_type_t<X, Y>;
+        return x < y ? static_cast<R>(y) : static_cast<R>(x);
+    }
+};
+
+template<>
+struct is_pure_operation<square_root> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<exponential> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<logarithm> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<power> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<absolute> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<minimum> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<maximum> : std::true_type {
+};
+
+/**
+ * The transcendental functions cost about as much as a dozen arithmetic
+ * operations.
+ */
+template<typename... T>
+struct cost<exponential, T...> : std::integral_constant<std::size_t, 16> {
+};
+
+template<typename... T>
+struct cost<logarithm, T...> : std::integral_constant<std::size_t, 16> {
+};
+
+template<typename... T>
+struct cost<power, T...> : std::integral_constant<std::size_t, 32> {
+};
+
+template<typename... T>
+struct cost<square_root, T...> : std::integral_constant<std::size_t, 4> {
+};
+
+/**
+ * Creates `sqrt(E)` compound expression.
+ */
+template<typename E, typename = Expression<E>>
+Compound<square_root, E> sqrt(E &&x) {
+    return Compound<square_root, E>(std::forward<E>(x));
+}
+
+/**
+ * Creates `exp(E)` compound expression.
+ */
+template<typename E, typename = Expression<E>>
+Compound<exponential, E> exp(E &&x) {
+    return Compound<exponential, E>(std::forward<E>(x));
+}
+
+/**
+ * Creates `log(E)` compound expression.
+ */
+template<typename E, typename = Expression<E>>
+Compound<logarithm, E> log(E &&x) {
+    return Compound<logarithm, E>(std::forward<E>(x));
+}
+
+/**
+ * Creates `abs(E)` compound expression.
+ */
+template<typename E, typename = Expression<E>>
+Compound<absolute, E> abs(E &&x) {
+    return Compound<absolute, E>(std::forward<E>(x));
+}
+
+/**
+ * Creates `pow(X, Y)` compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename T1, typename T2, typename = AnyExpression<T1, T2>>
+auto pow(T1 &&x, T2 &&y) {
+    return Compound<power, detail::stored_operand_t<T1>, detail::stored_operand_t<T2>>(
+        std::forward<T1>(x), std::forward<T2>(y));
+}
+
+/**
+ * Creates `min(X, Y)` compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename T1, typename T2, typename = AnyExpression<T1, T2>>
+auto min(T1 &&x, T2 &&y) {
+    return Compound<minimum, detail::stored_operand_t<T1>, detail::stored_operand_t<T2>>(
+        std::forward<T1>(x), std::forward<T2>(y));
+}
+
+/**
+ * Creates `max(X, Y)` compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename T1, typename T2, typename = AnyExpression<T1, T2>>
+auto max(T1 &&x, T2 &&y) {
+    return Compound<maximum, detail::stored_operand_t<T1>, detail::stored_operand_t<T2>>(
+        std::forward<T1>(x), std::forward<T2>(y));
+}
+
+} //::ctaeb
+
+#endif //CTAEB_MATH_H
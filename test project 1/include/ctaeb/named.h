@@ -0,0 +1,199 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `Named`, an evaluator that takes the values of the variables
+ * as named arguments. Requires C++20 (class types as template parameters).
+ */
+
+#ifndef CTAEB_NAMED_H
+#define CTAEB_NAMED_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+
+/**
+ * Set to 1 when the compiler supports class types as non-type template
+ * parameters, which `Named` needs to take names as template arguments.
+ */
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L
+#define CTAEB_HAS_NAMED_ARGUMENTS 1
+#else
+#define CTAEB_HAS_NAMED_ARGUMENTS 0
+#endif
+
+#if CTAEB_HAS_NAMED_ARGUMENTS
+
+namespace ctaeb {
+
+namespace detail {
+
+/**
+ * A string literal usable as a template argument.
+ */
+template<std::size_t N>
+struct FixedString {
+    constexpr FixedString(const char (&str)[N]) { // NOLINT
+        for (std::size_t i = 0; i < N; ++i) {
+            value[i] = str[i];
+        }
+    }
+
+    constexpr std::string_view view() const {
+        return std::string_view(value, N - 1);
+    }
+
+    char value[N];
+};
+
+} //::detail
+
+/**
+ * The value of the argument `Name`, created by `arg<Name> = value`. Holds
+ * a reference to the value, thus it must be passed to an evaluator in the same
+ * full-expression.
+ */
+template<detail::FixedString Name, typename T>
+struct Arg {
+    static constexpr auto name = Name;
+
+    T &&value;
+};
+
+/**
+ * The key of a named argument; see `arg`.
+ */
+template<detail::FixedString Name>
+struct ArgKey {
+    template<typename T>
+    constexpr Arg<Name, T> operator=(T &&value) const { // NOLINT
+        return Arg<Name, T>{std::forward<T>(value)};
+    }
+};
+
+/**
+ * Names an argument of `Named::operator()`: `arg<"x"> = 3`.
+ */
+template<detail::FixedString Name>
+inline constexpr ArgKey<Name> arg{};
+
+namespace detail {
+
+template<typename>
+struct is_arg : std::false_type {
+};
+
+template<FixedString Name, typename T>
+struct is_arg<Arg<Name, T>> : std::true_type {
+};
+
+/**
+ * The position of the argument `Name` among `Args`, or `sizeof...(Args)` if
+ * there's no such argument.
+ */
+template<FixedString Name, typename... Args>
+constexpr std::size_t arg_index() {
+    constexpr std::array<std::string_view, sizeof...(Args)> names = {{Args::name.view()...}};
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == Name.view()) {
+            return i;
+        }
+    }
+    return names.size();
+}
+
+/**
+ * Same as `arg_index`, but fails to compile if there's no argument `Name`;
+ * the name is shown in the compiler's message as the template argument.
+ */
+template<FixedString Name, typename... Args>
+constexpr std::size_t required_arg_index() {
+    constexpr std::size_t index = arg_index<Name, Args...>();
+    static_assert(index < sizeof...(Args), "ctaeb::Named: no value is given for the variable `Name`");
+    // avoids further errors
+    return index < sizeof...(Args) ? index : 0;
+}
+
+template<FixedString... Names>
+constexpr std::size_t name_count(std::string_view name) {
+    return ((Names.view() == name) + ... + 0);
+}
+
+template<typename... Args>
+constexpr bool unique_args() {
+    constexpr std::array<std::string_view, sizeof...(Args)> names = {{Args::name.view()...}};
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        for (std::size_t j = 0; j < i; ++j) {
+            if (names[i] == names[j]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} //::detail
+
+/**
+ * Evaluates an expression with the values of the variables given by name.
+ * The name of `Variable<I>` is the `I`-th of `Names`; the arguments may be
+ * given in any order:
+ * @code
+ * Variable<1> x("x");
+ * Variable<2> y("y");
+ * auto f = named<"x", "y">(x - y);
+ * int d = f(arg<"y"> = 4, arg<"x"> = 3); // -1
+ * @endcode
+ * The names are matched at compile time, thus the call is the same as
+ * the positional one, `(x - y)(3, 4)`. A missing or an unknown name, or
+ * a name given twice, is a compile-time error.
+ */
+template<typename E, detail::FixedString... Names>
+class Named {
+  public:
+    explicit Named(const E &expr) : expr_(expr) {
+    }
+
+    template<typename... Args>
+        requires (detail::is_arg<std::decay_t<Args>>::value && ...)
+    decltype(auto) operator()(Args &&... args) const {
+        static_assert(((detail::name_count<Names...>(std::decay_t<Args>::name.view()) == 1) && ...),
+                      "ctaeb::Named: unknown argument name");
+        static_assert(detail::unique_args<std::decay_t<Args>...>(),
+                      "ctaeb::Named: an argument is given more than once");
+        return expr_(detail::select<detail::required_arg_index<Names, std::decay_t<Args>...>()>(
+            args...).value...);
+    }
+
+    /**
+     * The evaluated expression.
+     */
+    const E &expression() const {
+        return expr_;
+    }
+
+  private:
+    E expr_;
+};
+
+/**
+ * Creates a `Named` evaluator of `expr`; see `Named`.
+ */
+template<detail::FixedString... Names, typename E, typename = Expression<E>>
+Named<std::decay_t<E>, Names...> named(const E &expr) {
+    return Named<std::decay_t<E>, Names...>(expr);
+}
+
+} //::ctaeb
+
+#endif
+
+#endif //CTAEB_NAMED_H
@@ -14,12 +14,261 @@
 #define CTAEB_OPERATIONS_H
 
 #include <functional>
+#include <ios>
 #include <type_traits>
 
 #include "expression.h"
 
 namespace ctaeb {
 
+/**
+ * `x << y`; @em functional has no function object for the shift operators.
+ */
+template<typename T = void>
+struct shift_left {
+    template<typename T1, typename T2>
+    constexpr auto operator()(T1 &&x, T2 &&y) const
+    -> decltype(std::forward<T1>(x) << std::forward<T2>(y)) {
+        return std::forward<T1>(x) << std::forward<T2>(y);
+    }
+};
+
+/**
+ * `x >> y`.
+ */
+template<typename T = void>
+struct shift_right {
+    template<typename T1, typename T2>
+    constexpr auto operator()(T1 &&x, T2 &&y) const
+    -> decltype(std::forward<T1>(x) >> std::forward<T2>(y)) {
+        return std::forward<T1>(x) >> std::forward<T2>(y);
+    }
+};
+
+namespace detail {
+
+/**
+ * Streams are never the left operand of a shift expression, so that
+ * `std::cout << expr` keeps printing the expression.
+ */
+template<typename T>
+using is_stream = std::is_base_of<std::ios_base, std::decay_t<T>>;
+
+} //::detail
+
+#if CTAEB_HAS_CONCEPTS
+
+// With concepts, each operator is a single constrained template. A value
+// operand is wrapped into `Constant` by `detail::operand_t`, so the
+// (expression, value) and (value, expression) forms need no separate
+// overloads, and overload resolution checks one constraint per candidate.
+
+/**
+ * Creates (X + Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator+(E1 &&x, E2 &&y) {
+    return Compound<std::plus, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X - Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator-(E1 &&x, E2 &&y) {
+    return Compound<std::minus, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X * Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator*(E1 &&x, E2 &&y) {
+    return Compound<std::multiplies, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X / Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator/(E1 &&x, E2 &&y) {
+    return Compound<std::divides, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X == Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator==(E1 &&x, E2 &&y) {
+    return Compound<std::equal_to, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X != Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator!=(E1 &&x, E2 &&y) {
+    return Compound<std::not_equal_to, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X < Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator<(E1 &&x, E2 &&y) {
+    return Compound<std::less, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X <= Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator<=(E1 &&x, E2 &&y) {
+    return Compound<std::less_equal, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X > Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator>(E1 &&x, E2 &&y) {
+    return Compound<std::greater, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X >= Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator>=(E1 &&x, E2 &&y) {
+    return Compound<std::greater_equal, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X && Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator&&(E1 &&x, E2 &&y) {
+    return Compound<std::logical_and, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X || Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator||(E1 &&x, E2 &&y) {
+    return Compound<std::logical_or, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X % Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator%(E1 &&x, E2 &&y) {
+    return Compound<std::modulus, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X & Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator&(E1 &&x, E2 &&y) {
+    return Compound<std::bit_and, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X | Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator|(E1 &&x, E2 &&y) {
+    return Compound<std::bit_or, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X ^ Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2>
+auto operator^(E1 &&x, E2 &&y) {
+    return Compound<std::bit_xor, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X << Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2> && (!detail::is_stream<E1>::value)
+auto operator<<(E1 &&x, E2 &&y) {
+    return Compound<shift_left, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (X >> Y) compound expression; at least one of X and Y must be
+ * an expression.
+ */
+template<typename E1, typename E2> requires expression_operands<E1, E2> && (!detail::is_stream<E1>::value)
+auto operator>>(E1 &&x, E2 &&y) {
+    return Compound<shift_right, detail::operand_t<E1>, detail::operand_t<E2>>(
+        std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (~E) compound expression.
+ */
+template<expression E>
+auto operator~(E &&x) {
+    return Compound<std::bit_not, E>(x);
+}
+
+/**
+ * Creates (!E) compound expression.
+ */
+template<expression E>
+auto operator!(E &&x) {
+    return Compound<std::logical_not, E>(x);
+}
+
+/**
+ * Creates (-E) compound expression.
+ */
+template<expression E>
+auto operator-(E &&x) {
+    return Compound<std::negate, E>(x);
+}
+
+#else
+
 /**
  * Creates (E1 + E2) compound expression.
  */
@@ -316,21 +565,165 @@ auto operator!(E &&x) {
     return Compound<std::logical_not, E>(x);
 }
 
+/**
+ * Creates (E1 % E2) compound expression.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+auto operator%(E1 &&x, E2 &&y) {
+    return ctaeb::Compound<std::modulus, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (E % T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<std::modulus, E, Constant<T>> operator%(E &&x, T &&y) {
+    return Compound<std::modulus, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T % E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>>
+Compound<std::modulus, Constant<T>, E> operator%(T &&x, E &&y) {
+    return Compound<std::modulus, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
+/**
+ * Creates (E1 & E2) compound expression.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+auto operator&(E1 &&x, E2 &&y) {
+    return ctaeb::Compound<std::bit_and, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (E & T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<std::bit_and, E, Constant<T>> operator&(E &&x, T &&y) {
+    return Compound<std::bit_and, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T & E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>>
+Compound<std::bit_and, Constant<T>, E> operator&(T &&x, E &&y) {
+    return Compound<std::bit_and, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
+/**
+ * Creates (E1 | E2) compound expression.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+auto operator|(E1 &&x, E2 &&y) {
+    return ctaeb::Compound<std::bit_or, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (E | T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<std::bit_or, E, Constant<T>> operator|(E &&x, T &&y) {
+    return Compound<std::bit_or, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T | E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>>
+Compound<std::bit_or, Constant<T>, E> operator|(T &&x, E &&y) {
+    return Compound<std::bit_or, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
 /**
  * Creates (E1 ^ E2) compound expression.
  */
-/*
 template<typename E1, typename E2, typename = Expressions<E1, E2>>
-auto operator ^(E1 &&x, E2 &&y) {
+auto operator^(E1 &&x, E2 &&y) {
     return ctaeb::Compound<std::bit_xor, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
 }
-*/
+
+/**
+ * Creates (E ^ T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<std::bit_xor, E, Constant<T>> operator^(E &&x, T &&y) {
+    return Compound<std::bit_xor, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T ^ E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>>
+Compound<std::bit_xor, Constant<T>, E> operator^(T &&x, E &&y) {
+    return Compound<std::bit_xor, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
+/**
+ * Creates (E1 << E2) compound expression.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+auto operator<<(E1 &&x, E2 &&y) {
+    return ctaeb::Compound<shift_left, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (E << T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<shift_left, E, Constant<T>> operator<<(E &&x, T &&y) {
+    return Compound<shift_left, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T << E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>, typename = std::enable_if_t<!detail::is_stream<T>::value>>
+Compound<shift_left, Constant<T>, E> operator<<(T &&x, E &&y) {
+    return Compound<shift_left, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
+/**
+ * Creates (E1 >> E2) compound expression.
+ */
+template<typename E1, typename E2, typename = Expressions<E1, E2>>
+auto operator>>(E1 &&x, E2 &&y) {
+    return ctaeb::Compound<shift_right, E1, E2>(std::forward<E1>(x), std::forward<E2>(y));
+}
+
+/**
+ * Creates (E >> T) compound expression.
+ */
+template<typename E, typename T, typename = Expression<E>, typename = NonExpression<T>>
+Compound<shift_right, E, Constant<T>> operator>>(E &&x, T &&y) {
+    return Compound<shift_right, E, Constant<T>>(std::forward<E>(x), std::forward<T>(y));
+}
+
+/**
+ * Creates (T >> E) compound expression.
+ */
+template<typename T, typename E, typename = NonExpression<T>, typename = Expression<E>, typename = std::enable_if_t<!detail::is_stream<T>::value>>
+Compound<shift_right, Constant<T>, E> operator>>(T &&x, E &&y) {
+    return Compound<shift_right, Constant<T>, E>(std::forward<T>(x), std::forward<E>(y));
+}
+
+/**
+ * Creates (~E) compound expression.
+ */
+template<typename E, typename = Expression<E> >
+auto operator~(E &&x) {
+    return Compound<std::bit_not, E>(x);
+}
 
 template<typename E, typename = Expression<E> >
 auto operator-(E &&x) {
     return Compound<std::negate, E>(x);
 }
 
+#endif // CTAEB_HAS_CONCEPTS
+
 }
 
 #endif //CTAEB_OPERATIONS_H
@@ -0,0 +1,397 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `ThreadPool` and `Parallel`, an evaluator that computes
+ * expensive operands of a compound concurrently.
+ */
+
+#ifndef CTAEB_PARALLEL_H
+#define CTAEB_PARALLEL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expression.h"
+#include "cost.h"
+
+namespace ctaeb {
+
+/**
+ * A set of tasks that are waited for together; see `ThreadPool::wait`.
+ */
+class TaskGroup {
+  public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+  private:
+    friend class ThreadPool;
+
+    std::atomic<std::size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+/**
+ * A work-stealing thread pool. Every worker has its own queue of tasks:
+ * tasks submitted by a worker go to its queue, a worker takes tasks from
+ * the back of its own queue and steals from the front of the others'
+ * queues when its queue is empty. A thread that waits for a group of tasks
+ * runs queued tasks meanwhile, so tasks may submit and wait for subtasks
+ * without exhausting the workers.
+ */
+class ThreadPool {
+  public:
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency())
+        : queues_(threads == 0 ? 1 : threads) {
+        for (std::size_t i = 0; i < queues_.size(); ++i) {
+            workers_.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    std::size_t size() const {
+        return workers_.size();
+    }
+
+    /**
+     * Queues `task` as a member of `group`. An exception thrown by the task
+     * is rethrown by `wait(group)`.
+     */
+    template<typename F>
+    void submit(TaskGroup &group, F &&task) {
+        group.pending_.fetch_add(1, std::memory_order_relaxed);
+        Task wrapped = [&group, task = std::forward<F>(task)]() mutable {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(group.error_mutex_);
+                if (!group.error_) {
+                    group.error_ = std::current_exception();
+                }
+            }
+            group.pending_.fetch_sub(1, std::memory_order_release);
+        };
+        std::size_t index = current_queue() < queues_.size()
+                            ? current_queue()
+                            : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        {
+            std::lock_guard<std::mutex> lock(queues_[index].mutex);
+            queues_[index].tasks.push_back(std::move(wrapped));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        {
+            // a worker that has just found no tasks must be waiting already
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+
+    /**
+     * Runs queued tasks until all the tasks of `group` have finished.
+     */
+    void join(TaskGroup &group) {
+        while (group.pending_.load(std::memory_order_acquire) != 0) {
+            if (!run_one(current_queue() % queues_.size())) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * Same as `join`, but then rethrows the first exception thrown by a task
+     * of `group`, if any.
+     */
+    void wait(TaskGroup &group) {
+        join(group);
+        if (group.error_) {
+            std::rethrow_exception(group.error_);
+        }
+    }
+
+  private:
+    using Task = std::function<void()>;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * The index of the calling worker's queue, or `SIZE_MAX` for threads
+     * that don't belong to the pool.
+     */
+    std::size_t &current_queue() {
+        thread_local std::size_t index = static_cast<std::size_t>(-1);
+        return index;
+    }
+
+    bool pop(std::size_t index, Task &task, bool own) {
+        auto &queue = queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        if (own) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool run_one(std::size_t index) {
+        Task task;
+        bool found = pop(index, task, true);
+        for (std::size_t i = 1; !found && i < queues_.size(); ++i) {
+            found = pop((index + i) % queues_.size(), task, false);
+        }
+        if (found) {
+            task();
+        }
+        return found;
+    }
+
+    void work(std::size_t index) {
+        current_queue() = index;
+        while (true) {
+            if (run_one(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_acquire) != 0;
+            });
+            if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<std::size_t> queued_{0};
+    std::atomic<std::size_t> next_queue_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+};
+
+namespace detail {
+
+/**
+ * Holds the result of an operand evaluated by a task: a value, or a pointer
+ * if the operand returns a reference.
+ */
+template<typename R>
+struct OperandResult {
+    std::optional<R> value;
+
+    template<typename F>
+    void compute(F &&f) {
+        value.emplace(f());
+    }
+
+    R get() {
+        return std::move(*value);
+    }
+};
+
+template<typename R>
+struct OperandResult<R &> {
+    R *value = nullptr;
+
+    template<typename F>
+    void compute(F &&f) {
+        value = &f();
+    }
+
+    R &get() {
+        return *value;
+    }
+};
+
+/**
+ * Operations whose `Invoker` evaluates the operands lazily.
+ */
+template<template<typename...> typename Op>
+struct is_short_circuit : std::false_type {
+};
+
+template<>
+struct is_short_circuit<std::logical_and> : std::true_type {
+};
+
+template<>
+struct is_short_circuit<std::logical_or> : std::true_type {
+};
+
+template<typename E, typename... Args>
+decltype(auto) parallel_eval(ThreadPool &, std::size_t, const E &expr, Args &... args) {
+    return expr(args...);
+}
+
+template<template<typename...> typename Op, typename... Nested, typename... Args>
+decltype(auto) parallel_eval(ThreadPool &pool, std::size_t threshold,
+                             const Compound<Op, Nested...> &expr, Args &... args);
+
+template<template<typename...> typename Op, typename... Nested, std::size_t... I,
+         typename... Args>
+decltype(auto) parallel_apply(ThreadPool &pool, std::size_t threshold,
+                              const Compound<Op, Nested...> &expr,
+                              std::index_sequence<I...>, Args &... args) {
+    const auto &operands = expr.get_expressions();
+    std::tuple<OperandResult<decltype(parallel_eval(pool, threshold, std::get<I>(operands), args...))>...>
+        results;
+
+    // all the expensive operands but the last one become tasks, the rest are
+    // evaluated by this thread while the tasks run
+    std::size_t remaining = (0 + ... + (expression_cost<std::decay_t<Nested>, Args...>::value >= threshold));
+    TaskGroup group;
+    auto spawn = [&](auto index) {
+        constexpr std::size_t J = decltype(index)::value;
+        auto &result = std::get<J>(results);
+        auto evaluate = [&pool, threshold, &operands, &result, &args...] {
+            result.compute([&]() -> decltype(auto) {
+                return parallel_eval(pool, threshold, std::get<J>(operands), args...);
+            });
+        };
+        using Operand = std::decay_t<std::tuple_element_t<J, std::tuple<Nested...>>>;
+        if (expression_cost<Operand, Args...>::value >= threshold && remaining-- > 1) {
+            pool.submit(group, evaluate);
+        } else {
+            evaluate();
+        }
+    };
+    try {
+        auto _ = {0, (spawn(std::integral_constant<std::size_t, I>()), 0)...};
+        static_cast<void>(_);
+    } catch (...) {
+        // the tasks refer to this frame
+        pool.join(group);
+        throw;
+    }
+    pool.wait(group);
+    return Op<void>()(std::get<I>(results).get()...);
+}
+
+template<template<typename...> typename Op, typename... Nested, std::size_t... I,
+         typename... Args>
+decltype(auto) parallel_lazy(ThreadPool &pool, std::size_t threshold,
+                             const Compound<Op, Nested...> &expr,
+                             std::index_sequence<I...>, Args &... args) {
+    const auto &operands = expr.get_expressions();
+    return Op<void>()([&pool, threshold, &operands, &args...]() -> decltype(auto) {
+        return parallel_eval(pool, threshold, std::get<I>(operands), args...);
+    }...);
+}
+
+template<template<typename...> typename Op, typename... Nested, typename... Args>
+decltype(auto) parallel_eval(ThreadPool &pool, std::size_t threshold,
+                             const Compound<Op, Nested...> &expr, Args &... args) {
+    if constexpr (is_short_circuit<Op>::value) {
+        // short-circuit operations evaluate their operands one by one, pure
+        // operands the cheapest first
+        constexpr std::size_t First = cost_order<std::tuple<Nested...>, Args...>::value[0];
+        const auto &operands = expr.get_expressions();
+        auto first = [&]() -> decltype(auto) {
+            return parallel_eval(pool, threshold, std::get<First>(operands), args...);
+        };
+        auto second = [&]() -> decltype(auto) {
+            return parallel_eval(pool, threshold, std::get<1 - First>(operands), args...);
+        };
+        if constexpr (std::is_same<Op<void>, std::logical_and<void>>::value) {
+            return static_cast<bool>(first()) && static_cast<bool>(second());
+        } else {
+            return static_cast<bool>(first()) || static_cast<bool>(second());
+        }
+    } else if constexpr (is_lazy_operation<Op>::value) {
+        // the operation decides which operands to evaluate
+        return parallel_lazy(pool, threshold, expr, std::index_sequence_for<Nested...>(), args...);
+    } else {
+        return parallel_apply(pool, threshold, expr, std::index_sequence_for<Nested...>(), args...);
+    }
+}
+
+} //::detail
+
+/**
+ * Evaluates an expression like the expression itself does, except that
+ * the operands of a compound whose sub-expressions cost at least
+ * `threshold` (see `expression_cost`) are evaluated as tasks of a
+ * `ThreadPool`. Cheap operands are evaluated inline, and so is the last
+ * expensive operand of every compound. @em && and @em || still evaluate
+ * their operands one after another, but if both operands are pure (see
+ * `is_pure_operation`), the cheaper one goes first. Lazy operations (see
+ * `is_lazy_operation`) get thunks that evaluate the operands in the same
+ * way. Operations must be safe
+ * to call concurrently on different data.
+ */
+template<typename E>
+class Parallel {
+  public:
+    Parallel(const E &expr, ThreadPool &pool, std::size_t threshold)
+        : expr_(expr), pool_(pool), threshold_(threshold) {
+    }
+
+    template<typename... Args>
+    decltype(auto) operator()(Args &&... args) const {
+        return detail::parallel_eval(pool_, threshold_, expr_, args...);
+    }
+
+  private:
+    E expr_;
+    ThreadPool &pool_;
+    std::size_t threshold_;
+};
+
+/**
+ * Creates a `Parallel` evaluator of `expr`:
+ * @code
+ * template<typename... T>
+ * struct ctaeb::cost<set_difference, T...> : std::integral_constant<std::size_t, 1000> {};
+ *
+ * ThreadPool pool;
+ * auto check = parallel(difference(a, b) == difference(c, d), pool);
+ * @endcode
+ */
+template<typename E, typename = Expression<E>>
+Parallel<std::decay_t<E>> parallel(const E &expr, ThreadPool &pool, std::size_t threshold = 1000) {
+    return Parallel<std::decay_t<E>>(expr, pool, threshold);
+}
+
+} //::ctaeb
+
+#endif //CTAEB_PARALLEL_H
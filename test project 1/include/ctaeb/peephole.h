@@ -0,0 +1,432 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `optimize`, which replaces range checks and chains of
+ * equality tests with single operations.
+ */
+
+#ifndef CTAEB_PEEPHOLE_H
+#define CTAEB_PEEPHOLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+#include "adaptive.h"
+#include "rewrite.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+template<typename T>
+constexpr bool is_integer_v = std::is_integral<T>::value && !std::is_same<T, bool>::value;
+
+/**
+ * Tells whether the range check `low <= x < high` may be done with one
+ * unsigned comparison: all the values are integers, and `x` is compared
+ * with both bounds in the same type.
+ */
+template<typename X, typename L, typename H>
+constexpr bool unsigned_range_check_v = is_integer_v<X> && is_integer_v<L> && is_integer_v<H> &&
+    std::is_same<std::common_type_t<X, L>, std::common_type_t<X, H>>::value;
+
+/**
+ * Returns `x - low` and `high - low` in the unsigned counterpart of
+ * the type in which `x` is compared with the bounds. If `low <= high`,
+ * `low <= x` and `x <= high` hold if and only if the first difference
+ * doesn't exceed the second one.
+ */
+template<typename X, typename L, typename H>
+auto unsigned_offsets(const X &x, const L &low, const H &high) {
+    using C = std::common_type_t<X, L>;
+    using U = std::make_unsigned_t<C>;
+    auto base = static_cast<U>(static_cast<C>(low));
+    return std::make_pair(static_cast<U>(static_cast<U>(static_cast<C>(x)) - base),
+                          static_cast<U>(static_cast<U>(static_cast<C>(high)) - base));
+}
+
+} //::detail
+
+/**
+ * `low <= x && x < high`; integers are checked with a single unsigned
+ * comparison, other values with two comparisons.
+ */
+template<typename T = void>
+struct in_range {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename L, typename H>
+    bool operator()(const X &x, const L &low, const H &high) const {
+        if constexpr (detail::unsigned_range_check_v<X, L, H>) {
+            using C = std::common_type_t<X, L>;
+            auto offsets = detail::unsigned_offsets(x, low, high);
+            return static_cast<bool>(static_cast<C>(low) <= static_cast<C>(high)) &
+                   static_cast<bool>(offsets.first < offsets.second);
+        } else {
+            return x >= low && x < high;
+        }
+    }
+};
+
+/**
+ * `low <= x && x <= high`; see `in_range`.
+ */
+template<typename T = void>
+struct in_closed_range {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename L, typename H>
+    bool operator()(const X &x, const L &low, const H &high) const {
+        if constexpr (detail::unsigned_range_check_v<X, L, H>) {
+            using C = std::common_type_t<X, L>;
+            auto offsets = detail::unsigned_offsets(x, low, high);
+            return static_cast<bool>(static_cast<C>(low) <= static_cast<C>(high)) &
+                   static_cast<bool>(offsets.first <= offsets.second);
+        } else {
+            return x >= low && x <= high;
+        }
+    }
+};
+
+/**
+ * A set of `K` values of the type `T`, the second operand of `one_of`.
+ * If the values are integers that span less than 64, membership is tested
+ * with a bit mask; otherwise integers are searched in the sorted values,
+ * and other values are compared with each of the values.
+ */
+template<typename T, std::size_t K>
+class ValueSet {
+  public:
+    explicit ValueSet(const std::array<T, K> &values) : values_(values) {
+        if constexpr (detail::is_integer_v<T>) {
+            using U = std::make_unsigned_t<T>;
+            std::sort(values_.begin(), values_.end());
+            min_ = values_.front();
+            auto span = static_cast<U>(static_cast<U>(values_.back()) - static_cast<U>(min_));
+            dense_ = span < 64;
+            for (const T &value : values_) {
+                auto offset = static_cast<U>(static_cast<U>(value) - static_cast<U>(min_));
+                mask_ |= dense_ ? std::uint64_t(1) << offset : 0;
+            }
+        }
+    }
+
+    /**
+     * Tells whether `x == value` for one of the values.
+     */
+    template<typename X>
+    bool contains(const X &x) const {
+        if constexpr (detail::is_integer_v<X> && detail::is_integer_v<T>) {
+            using C = std::common_type_t<X, T>;
+            // otherwise the conversion to `C` changes the order of the values
+            if constexpr (std::is_signed<C>::value == std::is_signed<T>::value) {
+                if (dense_) {
+                    using U = std::make_unsigned_t<C>;
+                    auto offset = static_cast<U>(static_cast<U>(static_cast<C>(x)) -
+                                                 static_cast<U>(static_cast<C>(min_)));
+                    return static_cast<bool>(offset < 64) &
+                           static_cast<bool>((mask_ >> (offset & 63)) & 1);
+                }
+                if constexpr (K > 16) {
+                    return std::binary_search(values_.begin(), values_.end(), static_cast<C>(x),
+                                              [](const auto &v1, const auto &v2) {
+                                                  return static_cast<C>(v1) < static_cast<C>(v2);
+                                              });
+                }
+            }
+        }
+        bool found = false;
+        for (const T &value : values_) {
+            found |= static_cast<bool>(x == value);
+        }
+        return found;
+    }
+
+    const std::array<T, K> &values() const {
+        return values_;
+    }
+
+    friend bool operator==(const ValueSet &set1, const ValueSet &set2) {
+        return set1.values_ == set2.values_;
+    }
+
+  private:
+    std::array<T, K> values_;
+    T min_{};
+    std::uint64_t mask_ = 0;
+    bool dense_ = false;
+};
+
+/**
+ * `x == v1 || x == v2 || ...`, where `set` is a `ValueSet` of `v1, v2, ...`.
+ */
+template<typename T = void>
+struct one_of {
+    static constexpr bool prefixed = true;
+
+    template<typename X, typename Set>
+    bool operator()(const X &x, const Set &set) const {
+        return set.contains(x);
+    }
+};
+
+template<>
+struct is_pure_operation<in_range> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<in_closed_range> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<one_of> : std::true_type {
+};
+
+namespace detail {
+
+template<typename T>
+struct peephole;
+
+/**
+ * Rewrites the operands of a compound; the operation stays as it is.
+ */
+template<typename T>
+struct peephole_operands;
+
+template<template<typename...> typename Op, typename... Nested>
+struct peephole_operands<Compound<Op, Nested...>> {
+    using type = Compound<Op, typename peephole<std::decay_t<Nested>>::type...>;
+
+    static type get(const Compound<Op, Nested...> &expr) {
+        return std::apply([](const auto &... nested) {
+            return type(peephole<std::decay_t<decltype(nested)>>::get(nested)...);
+        }, expr.get_expressions());
+    }
+};
+
+/**
+ * Computes the optimized type of the expression `T`; see `optimized_t`.
+ * Expressions other than compounds stay as they are.
+ */
+template<typename T>
+struct peephole {
+    using type = T;
+
+    static const T &get(const T &expr) {
+        return expr;
+    }
+};
+
+template<typename T>
+struct peephole<Constant<T>> {
+    using type = Constant<std::decay_t<T>>;
+
+    static type get(const Constant<T> &expr) {
+        return type(expr());
+    }
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct peephole<Compound<Op, Nested...>> : peephole_operands<Compound<Op, Nested...>> {
+};
+
+template<typename V1, typename V2>
+using same_variable = std::conjunction<is_variable<std::decay_t<V1>>,
+                                       std::is_same<std::decay_t<V1>, std::decay_t<V2>>>;
+
+/**
+ * Matches `x >= low && x < high` (`Op` is `in_range`) or
+ * `x >= low && x <= high` (`Op` is `in_closed_range`), where `x` is
+ * a variable, and `low` and `high` are constants.
+ */
+template<typename Lower, typename Upper>
+struct range_check : std::false_type {
+    using type = void;
+};
+
+template<template<typename...> typename Op, typename V, typename T1, typename T2>
+struct range_node : std::true_type {
+    using type = Compound<Op, std::decay_t<V>, Constant<std::decay_t<T1>>, Constant<std::decay_t<T2>>>;
+
+    template<typename Lower, typename Upper>
+    static type get(const Lower &lower, const Upper &upper) {
+        return type(std::get<0>(lower.get_expressions()),
+                    std::get<1>(lower.get_expressions())(),
+                    std::get<1>(upper.get_expressions())());
+    }
+};
+
+template<typename V1, typename T1, typename V2, typename T2>
+struct range_check<Compound<std::greater_equal, V1, Constant<T1>>,
+                   Compound<std::less, V2, Constant<T2>>>
+    : std::conditional_t<same_variable<V1, V2>::value,
+                         range_node<in_range, V1, T1, T2>, range_check<void, void>> {
+};
+
+template<typename V1, typename T1, typename V2, typename T2>
+struct range_check<Compound<std::greater_equal, V1, Constant<T1>>,
+                   Compound<std::less_equal, V2, Constant<T2>>>
+    : std::conditional_t<same_variable<V1, V2>::value,
+                         range_node<in_closed_range, V1, T1, T2>, range_check<void, void>> {
+};
+
+template<typename E1, typename E2>
+struct peephole<Compound<std::logical_and, E1, E2>> {
+    using Range = range_check<std::decay_t<E1>, std::decay_t<E2>>;
+    using Operands = peephole_operands<Compound<std::logical_and, E1, E2>>;
+    using type = std::conditional_t<Range::value, typename Range::type, typename Operands::type>;
+
+    static type get(const Compound<std::logical_and, E1, E2> &expr) {
+        if constexpr (Range::value) {
+            const auto &operands = expr.get_expressions();
+            return Range::get(std::get<0>(operands), std::get<1>(operands));
+        } else {
+            return Operands::get(expr);
+        }
+    }
+};
+
+/**
+ * Matches `x == value` or `value == x`, where `x` is a variable and `value`
+ * is a constant.
+ */
+template<typename E>
+struct equality_test : std::false_type {
+    using variable = void;
+    using value_type = void;
+};
+
+template<typename V, typename T>
+struct equality_test<Compound<std::equal_to, V, Constant<T>>>
+    : is_variable<std::decay_t<V>> {
+    using variable = std::decay_t<V>;
+    using value_type = std::decay_t<T>;
+
+    template<typename E>
+    static const variable &get_variable(const E &expr) {
+        return std::get<0>(expr.get_expressions());
+    }
+
+    template<typename E>
+    static const value_type &get_value(const E &expr) {
+        return std::get<1>(expr.get_expressions())();
+    }
+};
+
+template<typename T, typename V>
+struct equality_test<Compound<std::equal_to, Constant<T>, V>>
+    : is_variable<std::decay_t<V>> {
+    using variable = std::decay_t<V>;
+    using value_type = std::decay_t<T>;
+
+    template<typename E>
+    static const variable &get_variable(const E &expr) {
+        return std::get<1>(expr.get_expressions());
+    }
+
+    template<typename E>
+    static const value_type &get_value(const E &expr) {
+        return std::get<0>(expr.get_expressions())();
+    }
+};
+
+/**
+ * Matches a chain of `||` in which every operand compares the same variable
+ * with a constant of the same type.
+ */
+template<typename Operands>
+struct membership;
+
+template<typename First, typename... Rest>
+struct membership<std::tuple<First, Rest...>> {
+    using Test = equality_test<std::decay_t<First>>;
+    static constexpr bool value = Test::value &&
+        (equality_test<std::decay_t<Rest>>::value && ...) &&
+        (std::is_same<typename equality_test<std::decay_t<Rest>>::variable,
+                      typename Test::variable>::value && ...) &&
+        (std::is_same<typename equality_test<std::decay_t<Rest>>::value_type,
+                      typename Test::value_type>::value && ...);
+    using Set = ValueSet<typename Test::value_type, 1 + sizeof...(Rest)>;
+    using type = Compound<one_of, typename Test::variable, Constant<Set>>;
+
+    static type get(const std::tuple<First, Rest...> &operands) {
+        return std::apply([](const First &first, const Rest &... rest) {
+            std::array<typename Test::value_type, 1 + sizeof...(Rest)> values = {{
+                Test::get_value(first),
+                equality_test<std::decay_t<Rest>>::get_value(rest)...
+            }};
+            return type(Test::get_variable(first), Constant<Set>(Set(values)));
+        }, operands);
+    }
+};
+
+template<typename E1, typename E2>
+struct peephole<Compound<std::logical_or, E1, E2>> {
+    using Chain = chain_operands<std::logical_or, Compound<std::logical_or, E1, E2>>;
+    using Member = membership<typename Chain::type>;
+    using Operands = peephole_operands<Compound<std::logical_or, E1, E2>>;
+    using type = std::conditional_t<Member::value, typename Member::type, typename Operands::type>;
+
+    static type get(const Compound<std::logical_or, E1, E2> &expr) {
+        if constexpr (Member::value) {
+            return Member::get(Chain::get(expr));
+        } else {
+            return Operands::get(expr);
+        }
+    }
+};
+
+} //::detail
+
+/**
+ * The type of `optimize(expr)` for an expression of the type `E`. Like
+ * `canonical_t`, it holds every sub-expression by value.
+ */
+template<typename E>
+using optimized_t = typename detail::peephole<rewritten_t<E>>::type;
+
+/**
+ * Applies the user-defined rewrite rules (see `rewrite`), and then replaces
+ * the comparison patterns that are common in rule sets with operations that
+ * evaluate them faster:
+ * - `x >= low && x < high` becomes `in_range(x, low, high)`, and
+ *   `x >= low && x <= high` becomes `in_closed_range(x, low, high)`; for
+ *   integers, these are a subtraction and one unsigned comparison, with
+ *   no branch;
+ * - `x == v1 || x == v2 || ...`, with constants of the same type, becomes
+ *   `one_of(x, {v1, v2, ...})`; if the values are integers within 64 of
+ *   each other, this is a shift and a bit test.
+ *
+ * Here `x` is a variable and `low`, `high`, `v1`, `v2`, ... are constants.
+ * The equality tests must make up a whole chain of `||`; inside a longer
+ * one they are recognized if parenthesized, as in `a || (x == 1 || x == 2)`.
+ * The patterns are recognized at compile time from the type of the
+ * expression; the values of the constants are read when `optimize` is
+ * called. Other parts of the expression are copied as they are, and the
+ * result evaluates to the same value for the same arguments:
+ * @code
+ * Variable<1> x("x");
+ * auto e = optimize(x == 1 || x == 5 || x == 9);
+ * std::cout << e; // one_of(x, {1, 5, 9})
+ * @endcode
+ */
+template<typename E, typename = Expression<E>>
+optimized_t<E> optimize(const E &expr) {
+    return detail::peephole<rewritten_t<E>>::get(rewrite(expr));
+}
+
+} //::ctaeb
+
+#endif //CTAEB_PEEPHOLE_H
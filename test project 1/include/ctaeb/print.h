@@ -25,7 +25,19 @@
 // for std::index_sequence
 #include <utility>
 
+// for std::array
+#include <array>
+
+// for std::apply
+#include <tuple>
+
 #include "expression.h"
+#include "operations.h"
+#include "table.h"
+#include "let.h"
+#include "select.h"
+#include "math.h"
+#include "peephole.h"
 
 namespace ctaeb {
 
@@ -70,88 +82,180 @@ std::ostream &operator<<(std::ostream &os, const std::tuple<Args...> &tuple) {
 }
 
 /**
- * `ctaeb::to_string()` specializations for algebraic operations.
+ * `ctaeb::to_string()` specializations for algebraic operations. They are
+ * declared @em inline, like any other function defined in a header, so that
+ * `print.h` may be included by any number of translation units.
  */
 template<>
-std::string to_string<std::plus>() {
+inline std::string to_string<std::plus>() {
     return "+";
 }
 
 template<>
-std::string to_string<std::multiplies>() {
+inline std::string to_string<std::multiplies>() {
     return "*";
 }
 
 template<>
-std::string to_string<std::divides>() {
+inline std::string to_string<std::divides>() {
     return "/";
 }
 
 template<>
-std::string to_string<std::minus>() {
+inline std::string to_string<std::minus>() {
     return "-";
 }
 
 template<>
-std::string to_string<std::negate>() {
+inline std::string to_string<std::negate>() {
     return "-";
 }
 
 template<>
-std::string to_string<std::equal_to>() {
+inline std::string to_string<std::equal_to>() {
     return "==";
 }
 
 template<>
-std::string to_string<std::not_equal_to>() {
+inline std::string to_string<std::not_equal_to>() {
     return "!=";
 }
 
 template<>
-std::string to_string<std::less>() {
+inline std::string to_string<std::less>() {
     return "<";
 }
 
 template<>
-std::string to_string<std::less_equal>() {
+inline std::string to_string<std::less_equal>() {
     return "<=";
 }
 
 template<>
-std::string to_string<std::greater_equal>() {
+inline std::string to_string<std::greater_equal>() {
     return ">=";
 }
 
 template<>
-std::string to_string<std::greater>() {
+inline std::string to_string<std::greater>() {
     return ">";
 }
 
 template<>
-std::string to_string<std::logical_and>() {
+inline std::string to_string<std::logical_and>() {
     return "&&";
 }
 
 template<>
-std::string to_string<std::logical_or>() {
+inline std::string to_string<std::logical_or>() {
     return "||";
 }
 
 template<>
-std::string to_string<std::logical_not>() {
+inline std::string to_string<std::logical_not>() {
     return "not ";
 }
 
 template<>
-std::string to_string<std::unary_negate>() {
+inline std::string to_string<std::unary_negate>() {
     return "not ";
 }
 
 template<>
-std::string to_string<std::bit_xor>() {
+inline std::string to_string<std::modulus>() {
+    return "%";
+}
+
+template<>
+inline std::string to_string<std::bit_and>() {
+    return "&";
+}
+
+template<>
+inline std::string to_string<std::bit_or>() {
+    return "|";
+}
+
+template<>
+inline std::string to_string<std::bit_xor>() {
     return "^";
 }
 
+template<>
+inline std::string to_string<std::bit_not>() {
+    return "~";
+}
+
+template<>
+inline std::string to_string<shift_left>() {
+    return "<<";
+}
+
+template<>
+inline std::string to_string<shift_right>() {
+    return ">>";
+}
+
+template<>
+inline std::string to_string<if_then_else>() {
+    return "select";
+}
+
+template<>
+inline std::string to_string<branchless_select>() {
+    return "blend";
+}
+
+template<>
+inline std::string to_string<square_root>() {
+    return "sqrt";
+}
+
+template<>
+inline std::string to_string<exponential>() {
+    return "exp";
+}
+
+template<>
+inline std::string to_string<logarithm>() {
+    return "log";
+}
+
+template<>
+inline std::string to_string<power>() {
+    return "pow";
+}
+
+template<>
+inline std::string to_string<absolute>() {
+    return "abs";
+}
+
+template<>
+inline std::string to_string<minimum>() {
+    return "min";
+}
+
+template<>
+inline std::string to_string<maximum>() {
+    return "max";
+}
+
+template<>
+inline std::string to_string<in_range>() {
+    return "in_range";
+}
+
+template<>
+inline std::string to_string<in_closed_range>() {
+    return "in_closed_range";
+}
+
+template<>
+inline std::string to_string<one_of>() {
+    return "one_of";
+}
+
 template<typename>
 struct sfinae_true : std::true_type {
 };
@@ -193,6 +297,21 @@ std::ostream &operator<<(std::ostream &os, const Constant <T> &expr) {
     return os;
 }
 
+/**
+ * Writes the values of the set, such as `{1, 5, 9}`, into the given output
+ * stream.
+ */
+template<typename T, std::size_t K>
+std::ostream &operator<<(std::ostream &os, const ValueSet<T, K> &set) {
+    os << "{";
+    for (std::size_t i = 0; i < K; ++i) {
+        os << (i == 0 ? "" : ", ") << set.values()[i];
+    }
+    os << "}";
+
+    return os;
+}
+
 /**
  * Writes the variable's representation into the given output stream.
  */
@@ -253,6 +372,108 @@ std::ostream &operator<<(std::ostream &os, const Compound <Op, T1, T2> &expr) {
     return os;
 }
 
+/**
+ * Writes the local's name into the given output stream.
+ */
+template<std::size_t N>
+std::ostream &operator<<(std::ostream &os, const Local<N> &expr) {
+    os << expr.name();
+
+    return os;
+}
+
+/**
+ * Writes `let(t = bound, body)` into the given output stream.
+ */
+template<std::size_t N, typename Bound, typename Body>
+std::ostream &operator<<(std::ostream &os, const Let<N, Bound, Body> &expr) {
+    os << "let(" << expr.local() << " = " << expr.bound() << ", " << expr.body() << ")";
+
+    return os;
+}
+
+namespace print {
+
+template<typename T>
+std::ostream &print_table_node(std::ostream &os, const T &table, std::size_t index);
+
+/**
+ * Prints a table node that is an ordinary expression.
+ */
+template<typename T, typename E>
+std::ostream &print_node(std::ostream &os, const T &, const E &expr) {
+    return os << expr;
+}
+
+/**
+ * Prints an operation node of a table in the same form `Compound` with
+ * the same operation is printed.
+ */
+template<typename T, template<typename...> typename Op, std::size_t... I>
+std::ostream &print_node(std::ostream &os, const T &table, const Node<Op, I...> &) {
+    constexpr std::size_t indices[] = {I...};
+    constexpr bool use_prefix_form = prefixed<Op>::value;
+
+    if constexpr (sizeof...(I) == 1 && !use_prefix_form) {
+        print::print_table_node(os << to_string<Op>(), table, indices[0]);
+    }
+    else if constexpr (sizeof...(I) == 2 && !use_prefix_form) {
+        print::print_table_node(os, table, indices[0]);
+        os << " " << to_string<Op>() << " ";
+        print::print_table_node(os, table, indices[1]);
+    }
+    else {
+        std::size_t printed = 0;
+        os << to_string<Op>() << "(";
+        auto _ = {0, (print::print_table_node(os << (printed++ ? ", " : ""), table, I), 0)...};
+        static_cast<void>(_);
+        os << ")";
+    }
+
+    return os;
+}
+
+template<typename T, std::size_t I, typename Node>
+std::ostream &print_slot(std::ostream &os, const T &table) {
+    return print::print_node(os, table, static_cast<const detail::TableSlot<I, Node> &>(table).node);
+}
+
+/**
+ * See `detail::make_table_evaluators` for why the table type is a separate
+ * parameter.
+ */
+template<typename T, typename... Nodes, std::size_t... I>
+constexpr auto make_node_printers(const detail::TableStorage<std::index_sequence<I...>, Nodes...> *) {
+    using Printer = std::ostream &(*)(std::ostream &, const T &);
+    return std::array<Printer, sizeof...(I)>{{&print_slot<T, I, Nodes>...}};
+}
+
+/**
+ * Printers of all the nodes of a table. Like `Table` evaluation, printing
+ * goes through this array, so that printer instantiations do not nest.
+ */
+template<typename T>
+constexpr auto node_printers = print::make_node_printers<T>(static_cast<const T *>(nullptr));
+
+/**
+ * Prints the node with the given index.
+ */
+template<typename T>
+std::ostream &print_table_node(std::ostream &os, const T &table, std::size_t index) {
+    return node_printers<T>[index](os, table);
+}
+
+} // print::
+
+/**
+ * Writes the table's representation into the given output stream. A table
+ * is printed in the same way as the equivalent `Compound`.
+ */
+template<typename... Nodes>
+std::ostream &operator<<(std::ostream &os, const Table<Nodes...> &table) {
+    return print::print_table_node(os, table, sizeof...(Nodes) - 1);
+}
+
 template <typename T, typename = Expression<T>>
 std::string to_string(T && expr) {
     std::stringstream str_stream;
@@ -263,6 +484,61 @@ std::string to_string(T && expr) {
     return invariant_str;
 }
 
+#ifdef CTAEB_INSTRUMENTATION
+namespace instrumentation {
+
+template<typename E>
+void report_node(std::ostream &, const E &, std::size_t) {
+}
+
+template<template<typename...> typename Op, typename... Nested>
+void report_node(std::ostream &os, const Compound<Op, Nested...> &expr, std::size_t depth) {
+    Totals totals = counters<Compound<Op, Nested...>>().totals();
+    os << totals.calls << '\t'
+       << totals.short_circuits << '\t'
+       << totals.cycles << '\t'
+       << std::string(2 * depth, ' ') << expr << '\n';
+    std::apply([&os, depth](const auto &... nested) {
+        auto _ = {0, (report_node(os, nested, depth + 1), 0)...};
+        static_cast<void>(_);
+    }, expr.get_expressions());
+}
+
+/**
+ * Writes the counters of every compound node of `expr`, one node per line,
+ * next to the node's representation. Sub-expressions are indented under
+ * their parents. The columns are: evaluations, short-circuits, cycles.
+ */
+template<typename E, typename = Expression<E>>
+void report(std::ostream &os, const E &expr) {
+    os << "calls\tshort-circuits\tcycles\texpression\n";
+    report_node(os, expr, 0);
+}
+
+template<typename E>
+void reset_node(const E &) {
+}
+
+template<template<typename...> typename Op, typename... Nested>
+void reset_node(const Compound<Op, Nested...> &expr) {
+    counters<Compound<Op, Nested...>>().reset();
+    std::apply([](const auto &... nested) {
+        auto _ = {0, (reset_node(nested), 0)...};
+        static_cast<void>(_);
+    }, expr.get_expressions());
+}
+
+/**
+ * Resets the counters of every compound node of `expr`.
+ */
+template<typename E, typename = Expression<E>>
+void reset(const E &expr) {
+    reset_node(expr);
+}
+
+} //::instrumentation
+#endif
+
 } // ctaeb::
 
 #endif //CTAEB_PRINT_H
@@ -0,0 +1,344 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `rewrite`, which applies user-defined rewrite rules to
+ * an expression at compile time.
+ */
+
+#ifndef CTAEB_REWRITE_H
+#define CTAEB_REWRITE_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+
+namespace ctaeb {
+
+/**
+ * A variable of a rewrite rule's pattern, which matches any sub-expression.
+ * If a placeholder appears in a pattern several times, all of its
+ * occurrences must match the same sub-expression; since this is checked
+ * by the types, such sub-expressions may consist of variables and
+ * compounds of them only.
+ * In a replacement, a placeholder stands for the sub-expression it matched.
+ */
+template<std::size_t N>
+struct Placeholder {
+};
+
+/**
+ * A rewrite rule: an expression that matches `Pattern` is replaced with
+ * `Replacement`. Both are expression types in the canonical form (see
+ * `canonical_t`) built of `Compound`, `Variable`, and `Placeholder`;
+ * a `Variable<N>` matches only itself. Every placeholder of `Replacement`
+ * must appear in `Pattern`.
+ */
+template<typename Pattern, typename Replacement>
+struct Rule {
+};
+
+/**
+ * The rules that `rewrite` applies to compounds of the operation `Op`,
+ * as `std::tuple<Rule<Pattern, Replacement>...>`; the pattern of each rule
+ * must be a compound of `Op`. There are no rules by default; specialize
+ * this template for user-defined operations:
+ * @code
+ * template<>
+ * struct rewrite_rules<from_polar> {
+ *     using type = std::tuple<
+ *         Rule<Compound<from_polar, Compound<to_polar, Placeholder<1>>>,
+ *              Placeholder<1>>>;
+ * };
+ * @endcode
+ * Like `is_commutative`, the specialization must be visible wherever
+ * expressions of `Op` are rewritten.
+ */
+template<template<typename...> typename Op>
+struct rewrite_rules {
+    using type = std::tuple<>;
+};
+
+namespace detail {
+
+template<typename Key, typename T>
+struct Binding {
+};
+
+/**
+ * The sub-expression bound to `Key`, a placeholder or a variable of
+ * a pattern, by the bindings `Bound`, or @em void if there's none.
+ */
+template<typename Key, typename Bound>
+struct bound_expression {
+    using type = void;
+};
+
+template<typename Key, typename T, typename... Bindings>
+struct bound_expression<Key, std::tuple<Binding<Key, T>, Bindings...>> {
+    using type = T;
+};
+
+template<typename Key, typename Other, typename... Bindings>
+struct bound_expression<Key, std::tuple<Other, Bindings...>>
+    : bound_expression<Key, std::tuple<Bindings...>> {
+};
+
+/**
+ * The position of `Key` in the bindings `Bound`.
+ */
+template<typename Key, typename Bound>
+struct binding_index;
+
+template<typename Key, typename T, typename... Bindings>
+struct binding_index<Key, std::tuple<Binding<Key, T>, Bindings...>>
+    : std::integral_constant<std::size_t, 0> {
+};
+
+template<typename Key, typename Other, typename... Bindings>
+struct binding_index<Key, std::tuple<Other, Bindings...>>
+    : std::integral_constant<std::size_t, 1 + binding_index<Key, std::tuple<Bindings...>>::value> {
+};
+
+/**
+ * Tells whether the value of the expression `E` depends on its type only,
+ * so that two sub-expressions of the type `E` are the same.
+ */
+template<typename E>
+struct is_value_free : is_variable<E> {
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct is_value_free<Compound<Op, Nested...>> : std::conjunction<is_value_free<Nested>...> {
+};
+
+/**
+ * Matches the pattern `P` with the canonical expression `E`, given
+ * the bindings `Bound` of the placeholders to the left of `P`. `bound`
+ * adds the placeholders of `P`, and `collect` returns the sub-expressions
+ * they are bound to, in the same order.
+ */
+template<typename P, typename E, typename Bound>
+struct match : std::false_type {
+    using bound = Bound;
+};
+
+/**
+ * Binds `Key` to the sub-expression `E`, unless it's already bound to
+ * the same one.
+ */
+template<typename Key, typename E, typename Bound>
+struct bind {
+    using previous = typename bound_expression<Key, Bound>::type;
+    static constexpr bool value = std::is_void<previous>::value ||
+        (std::is_same<previous, E>::value && is_value_free<E>::value);
+    using bound = std::conditional_t<std::is_void<previous>::value,
+        decltype(std::tuple_cat(std::declval<Bound>(), std::declval<std::tuple<Binding<Key, E>>>())),
+        Bound>;
+
+    static auto collect(const E &expr) {
+        if constexpr (std::is_void<previous>::value) {
+            return std::tuple<E>(expr);
+        } else {
+            return std::tuple<>();
+        }
+    }
+};
+
+template<std::size_t N, typename E, typename Bound>
+struct match<Placeholder<N>, E, Bound> : bind<Placeholder<N>, E, Bound> {
+};
+
+template<std::size_t N, typename Bound>
+struct match<Variable<N>, Variable<N>, Bound> : bind<Variable<N>, Variable<N>, Bound> {
+};
+
+template<typename Patterns, typename Operands, typename Bound>
+struct match_operands : std::false_type {
+    using bound = Bound;
+};
+
+template<typename Bound>
+struct match_operands<std::tuple<>, std::tuple<>, Bound> : std::true_type {
+    using bound = Bound;
+
+    static std::tuple<> collect() {
+        return {};
+    }
+};
+
+template<typename P, typename... Ps, typename E, typename... Es, typename Bound>
+struct match_operands<std::tuple<P, Ps...>, std::tuple<E, Es...>, Bound> {
+    using Head = match<P, E, Bound>;
+    using Tail = match_operands<std::tuple<Ps...>, std::tuple<Es...>, typename Head::bound>;
+    static constexpr bool value = Head::value && Tail::value;
+    using bound = typename Tail::bound;
+
+    static auto collect(const E &expr, const Es &... rest) {
+        return std::tuple_cat(Head::collect(expr), Tail::collect(rest...));
+    }
+};
+
+template<template<typename...> typename Op, typename... Ps, typename... Es, typename Bound>
+struct match<Compound<Op, Ps...>, Compound<Op, Es...>, Bound>
+    : match_operands<std::tuple<Ps...>, std::tuple<Es...>, Bound> {
+    using Operands = match_operands<std::tuple<Ps...>, std::tuple<Es...>, Bound>;
+
+    static auto collect(const Compound<Op, Es...> &expr) {
+        return std::apply([](const Es &... nested) {
+            return Operands::collect(nested...);
+        }, expr.get_expressions());
+    }
+};
+
+/**
+ * Builds the replacement `R` from the sub-expressions `values` bound by
+ * `Bound`. A variable of the replacement is copied from the pattern, if it
+ * appears there, so that it keeps its name.
+ */
+template<typename R, typename Bound>
+struct substitute;
+
+template<std::size_t N, typename Bound>
+struct substitute<Placeholder<N>, Bound> {
+    using type = typename bound_expression<Placeholder<N>, Bound>::type;
+    static_assert(!std::is_void<type>::value,
+                  "ctaeb::Rule: a placeholder of the replacement is not in the pattern");
+
+    template<typename Values>
+    static const type &get(const Values &values) {
+        return std::get<binding_index<Placeholder<N>, Bound>::value>(values);
+    }
+};
+
+template<std::size_t N, typename Bound>
+struct substitute<Variable<N>, Bound> {
+    using type = Variable<N>;
+
+    template<typename Values>
+    static type get(const Values &values) {
+        if constexpr (std::is_void<typename bound_expression<type, Bound>::type>::value) {
+            return type();
+        } else {
+            return std::get<binding_index<type, Bound>::value>(values);
+        }
+    }
+};
+
+template<template<typename...> typename Op, typename... Rs, typename Bound>
+struct substitute<Compound<Op, Rs...>, Bound> {
+    using type = Compound<Op, typename substitute<Rs, Bound>::type...>;
+
+    template<typename Values>
+    static type get(const Values &values) {
+        return type(substitute<Rs, Bound>::get(values)...);
+    }
+};
+
+/**
+ * Finds the first of the rules `Rules` whose pattern matches
+ * the canonical expression `E`.
+ */
+template<typename Rules, typename E>
+struct first_rule : std::false_type {
+    using type = void;
+};
+
+template<typename P, typename R, typename... Rules, typename E>
+struct first_rule<std::tuple<Rule<P, R>, Rules...>, E>
+    : std::conditional_t<match<P, E, std::tuple<>>::value,
+                         std::true_type, first_rule<std::tuple<Rules...>, E>> {
+    using Match = match<P, E, std::tuple<>>;
+    using Next = first_rule<std::tuple<Rules...>, E>;
+    using Substitute = substitute<R, typename Match::bound>;
+    using type = typename std::conditional_t<Match::value, Substitute, Next>::type;
+
+    static type get(const E &expr) {
+        if constexpr (Match::value) {
+            return Substitute::get(Match::collect(expr));
+        } else {
+            return Next::get(expr);
+        }
+    }
+};
+
+/**
+ * Computes the rewritten type of the canonical expression `T`; see
+ * `rewritten_t`. The operands of a compound are rewritten first, and then
+ * the compound itself, until no rule matches.
+ */
+template<typename T>
+struct rewriter {
+    using type = T;
+
+    static const T &get(const T &expr) {
+        return expr;
+    }
+};
+
+template<bool Found, typename Rules, typename E>
+struct rewrite_step {
+    using type = E;
+
+    static const E &get(const E &expr) {
+        return expr;
+    }
+};
+
+template<typename Rules, typename E>
+struct rewrite_step<true, Rules, E> {
+    using Found = first_rule<Rules, E>;
+    using type = typename rewriter<typename Found::type>::type;
+
+    static type get(const E &expr) {
+        return rewriter<typename Found::type>::get(Found::get(expr));
+    }
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct rewriter<Compound<Op, Nested...>> {
+    using Rules = typename rewrite_rules<Op>::type;
+    using Operands = Compound<Op, typename rewriter<Nested>::type...>;
+    using Step = rewrite_step<first_rule<Rules, Operands>::value, Rules, Operands>;
+    using type = typename Step::type;
+
+    static type get(const Compound<Op, Nested...> &expr) {
+        return std::apply([](const Nested &... nested) {
+            return Step::get(Operands(rewriter<Nested>::get(nested)...));
+        }, expr.get_expressions());
+    }
+};
+
+} //::detail
+
+/**
+ * The type of `rewrite(expr)` for an expression of the type `E`.
+ */
+template<typename E>
+using rewritten_t = typename detail::rewriter<canonical_t<E>>::type;
+
+/**
+ * Converts the expression to its canonical form (see `canonical_t`), and
+ * applies the rules of `rewrite_rules` to it: the sub-expressions are
+ * rewritten before the expressions that contain them, and each one is
+ * rewritten until none of the rules of its operation matches. Matching is
+ * done at compile time, by the types of the sub-expressions, so the result
+ * has its own type and the evaluation doesn't test any patterns. Rules must
+ * not rewrite an expression back and forth, otherwise the compilation
+ * doesn't end. `optimize` applies the rules as well.
+ */
+template<typename E, typename = Expression<E>>
+rewritten_t<E> rewrite(const E &expr) {
+    return detail::rewriter<canonical_t<E>>::get(canonical(expr));
+}
+
+} //::ctaeb
+
+#endif //CTAEB_REWRITE_H
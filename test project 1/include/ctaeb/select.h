@@ -0,0 +1,133 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines conditional expressions: `select`, which evaluates only
+ * the chosen branch, and `blend`, which evaluates both and chooses without
+ * branching.
+ */
+
+#ifndef CTAEB_SELECT_H
+#define CTAEB_SELECT_H
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+#include "canonical.h"
+
+namespace ctaeb {
+
+namespace detail {
+
+/**
+ * The type of a conditional whose branches have the types `R1` and `R2`:
+ * a reference if both branches are the same reference, their common type
+ * otherwise.
+ */
+template<typename R1, typename R2>
+using conditional_result_t = std::conditional_t<std::is_same<R1, R2>::value,
+                                                R1, std::common_type_t<R1, R2>>;
+
+} //::detail
+
+/**
+ * The operation of `select`: `condition ? value1 : value2`. It's a lazy
+ * operation (see `is_lazy_operation`): it evaluates the condition, and then
+ * only one of the values.
+ */
+template<typename T = void>
+struct if_then_else {
+    static constexpr bool prefixed = true;
+    static constexpr bool lazy = true;
+
+    template<typename C, typename F1, typename F2>
+    constexpr decltype(auto) operator()(const C &condition, const F1 &value1, const F2 &value2) const {
+        using R = detail::conditional_result_t<decltype(value1()), decltype(value2())>;
+        if (condition()) {
+            return static_cast<R>(value1());
+        }
+        return static_cast<R>(value2());
+    }
+};
+
+/**
+ * The operation of `blend`: same as `if_then_else`, but integers are chosen
+ * with a bit mask instead of a jump, and the result is always a value.
+ */
+template<typename T = void>
+struct branchless_select {
+    static constexpr bool prefixed = true;
+
+    template<typename C, typename T1, typename T2>
+    constexpr auto operator()(const C &condition, const T1 &value1, const T2 &value2) const {
+        using R = std::common_type_t<T1, T2>;
+        if constexpr (std::is_integral<R>::value && !std::is_same<R, bool>::value) {
+            // all ones if the condition holds, zero otherwise
+            R mask = static_cast<R>(R(0) - static_cast<R>(static_cast<bool>(condition)));
+            return static_cast<R>((static_cast<R>(value1) & mask) |
+                                  (static_cast<R>(value2) & static_cast<R>(~mask)));
+        } else {
+            return static_cast<bool>(condition) ? static_cast<R>(value1) : static_cast<R>(value2);
+        }
+    }
+};
+
+template<>
+struct is_pure_operation<if_then_else> : std::true_type {
+};
+
+template<>
+struct is_pure_operation<branchless_select> : std::true_type {
+};
+
+namespace detail {
+
+} //::detail
+
+/**
+ * Creates the expression `condition ? value1 : value2`, which evaluates
+ * only one of the values:
+ * @code
+ * auto safe_ratio = select(y != 0, x / y, 0);
+ * @endcode
+ * At least one of the arguments must be an expression.
+ */
+template<typename C, typename T1, typename T2, typename = AnyExpression<C, T1, T2>>
+auto select(C &&condition, T1 &&value1, T2 &&value2) {
+    return Compound<if_then_else,
+                    detail::stored_operand_t<C>,
+                    detail::stored_operand_t<T1>,
+                    detail::stored_operand_t<T2>>(
+        std::forward<C>(condition), std::forward<T1>(value1), std::forward<T2>(value2));
+}
+
+/**
+ * Same as `select`, but evaluates both values, and then chooses one of them
+ * without a jump. In a loop over columns of values, such as
+ * @code
+ * auto clamp = blend(x > limit, limit, x);
+ * for (std::size_t i = 0; i < xs.size(); ++i) {
+ *     out[i] = clamp(xs[i]);
+ * }
+ * @endcode
+ * this lets the compiler vectorize the loop, and there are no branch
+ * mispredictions when the condition is unpredictable. Both values must be
+ * cheap and safe to evaluate regardless of the condition.
+ */
+template<typename C, typename T1, typename T2, typename = AnyExpression<C, T1, T2>>
+auto blend(C &&condition, T1 &&value1, T2 &&value2) {
+    return Compound<branchless_select,
+                    detail::stored_operand_t<C>,
+                    detail::stored_operand_t<T1>,
+                    detail::stored_operand_t<T2>>(
+        std::forward<C>(condition), std::forward<T1>(value1), std::forward<T2>(value2));
+}
+
+} //::ctaeb
+
+#endif //CTAEB_SELECT_H
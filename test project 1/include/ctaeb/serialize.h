@@ -0,0 +1,395 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines a binary format of expressions, `serialize` that writes it,
+ * and `load` that makes an expression of a known type from it without
+ * copying the constants.
+ */
+
+#ifndef CTAEB_SERIALIZE_H
+#define CTAEB_SERIALIZE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expression.h"
+#include "operations.h"
+#include "canonical.h"
+
+namespace ctaeb {
+
+/**
+ * Identifies the operation `Op` in the binary format. Operations from
+ * @em functional have fixed identifiers. Other operations get a hash of
+ * their names, which is the same for all programs built by one compiler;
+ * specialize this template to give an operation a fixed identifier in
+ * the range [64, 0x8000).
+ */
+template<template<typename...> typename Op>
+struct operation_id {
+    static constexpr std::uint16_t value = [] {
+        std::uint32_t hash = 2166136261u;
+        for (char c : detail::type_signature<Op<void>>()) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return static_cast<std::uint16_t>(0x8000u | (hash & 0x7fffu));
+    }();
+};
+
+#define CTAEB_OPERATION_ID(op, id) \
+    template<> \
+    struct operation_id<op> { \
+        static constexpr std::uint16_t value = id; \
+    }
+
+CTAEB_OPERATION_ID(std::plus, 1);
+CTAEB_OPERATION_ID(std::minus, 2);
+CTAEB_OPERATION_ID(std::multiplies, 3);
+CTAEB_OPERATION_ID(std::divides, 4);
+CTAEB_OPERATION_ID(std::modulus, 5);
+CTAEB_OPERATION_ID(std::negate, 6);
+CTAEB_OPERATION_ID(std::equal_to, 7);
+CTAEB_OPERATION_ID(std::not_equal_to, 8);
+CTAEB_OPERATION_ID(std::less, 9);
+CTAEB_OPERATION_ID(std::less_equal, 10);
+CTAEB_OPERATION_ID(std::greater, 11);
+CTAEB_OPERATION_ID(std::greater_equal, 12);
+CTAEB_OPERATION_ID(std::logical_and, 13);
+CTAEB_OPERATION_ID(std::logical_or, 14);
+CTAEB_OPERATION_ID(std::logical_not, 15);
+CTAEB_OPERATION_ID(std::bit_and, 16);
+CTAEB_OPERATION_ID(std::bit_or, 17);
+CTAEB_OPERATION_ID(std::bit_xor, 18);
+CTAEB_OPERATION_ID(std::bit_not, 19);
+CTAEB_OPERATION_ID(shift_left, 20);
+CTAEB_OPERATION_ID(shift_right, 21);
+
+#undef CTAEB_OPERATION_ID
+
+/**
+ * Provides the binary format of expressions.
+ *
+ * An expression is written as a block that starts with a `Header`, which is
+ * followed by one `Record` per node in prefix order (a compound, then its
+ * operands), and then by the payloads: the names of the variables and
+ * the values of the constants. Constant payloads are aligned to 16 bytes
+ * within the block, and blocks are padded to a multiple of 16 bytes, thus
+ * a file may hold several blocks back to back. All the numbers are in
+ * the byte order of the machine that wrote them.
+ */
+namespace serialization {
+
+constexpr std::uint32_t magic = 0x42454143; // "CAEB"
+constexpr std::uint16_t version = 1;
+constexpr std::size_t alignment = 16;
+
+struct Header {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t reserved;
+    std::uint32_t node_count;
+    /**
+     * The size of the block in bytes, including the header and the padding.
+     */
+    std::uint32_t size;
+};
+
+enum class Kind : std::uint8_t {
+    constant = 0,
+    variable = 1,
+    compound = 2
+};
+
+struct Record {
+    Kind kind;
+    /**
+     * The number of operands of a compound.
+     */
+    std::uint8_t arity;
+    /**
+     * `operation_id` of a compound's operation.
+     */
+    std::uint16_t operation;
+    /**
+     * The index `N` of a variable.
+     */
+    std::uint32_t index;
+    /**
+     * Offset of the payload from the beginning of the block.
+     */
+    std::uint32_t offset;
+    /**
+     * Size of the payload: the length of a variable's name, or the size of
+     * a constant's value.
+     */
+    std::uint32_t size;
+};
+
+static_assert(sizeof(Header) == 16, "unexpected padding in Header");
+static_assert(sizeof(Record) == 16, "unexpected padding in Record");
+
+} //::serialization
+
+namespace detail {
+
+template<typename T>
+struct node_count : std::integral_constant<std::size_t, 1> {
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct node_count<Compound<Op, Nested...>>
+    : std::integral_constant<std::size_t, (1 + ... + node_count<Nested>::value)> {
+};
+
+/**
+ * The type that `load` makes from the canonical expression type `T`:
+ * constants refer to the loaded values instead of holding copies.
+ */
+template<typename T>
+struct mapped {
+    using type = T;
+};
+
+template<typename T>
+struct mapped<Constant<T>> {
+    using type = Constant<const T &>;
+};
+
+template<template<typename...> typename Op, typename... Nested>
+struct mapped<Compound<Op, Nested...>> {
+    using type = Compound<Op, typename mapped<Nested>::type...>;
+};
+
+class BlockWriter {
+  public:
+    BlockWriter(std::vector<unsigned char> &out, std::size_t node_count)
+        : out_(out), begin_(out.size()), record_(0) {
+        payload_ = sizeof(serialization::Header) + node_count * sizeof(serialization::Record);
+        out_.resize(begin_ + payload_, 0);
+        serialization::Header header{serialization::magic, serialization::version, 0,
+                                     static_cast<std::uint32_t>(node_count), 0};
+        std::memcpy(out_.data() + begin_, &header, sizeof(header));
+    }
+
+    void add(const serialization::Record &record, const void *payload, std::size_t align) {
+        serialization::Record copy = record;
+        if (payload) {
+            payload_ = (payload_ + align - 1) / align * align;
+            copy.offset = static_cast<std::uint32_t>(payload_);
+            out_.resize(begin_ + payload_ + copy.size, 0);
+            std::memcpy(out_.data() + begin_ + payload_, payload, copy.size);
+            payload_ += copy.size;
+        }
+        std::size_t position = begin_ + sizeof(serialization::Header) +
+                               record_++ * sizeof(serialization::Record);
+        std::memcpy(out_.data() + position, &copy, sizeof(copy));
+    }
+
+    void finish() {
+        payload_ = (payload_ + serialization::alignment - 1) /
+                   serialization::alignment * serialization::alignment;
+        out_.resize(begin_ + payload_, 0);
+        auto size = static_cast<std::uint32_t>(payload_);
+        std::memcpy(out_.data() + begin_ + offsetof(serialization::Header, size),
+                    &size, sizeof(size));
+    }
+
+  private:
+    std::vector<unsigned char> &out_;
+    std::size_t begin_;
+    std::size_t record_;
+    std::size_t payload_;
+};
+
+template<typename T>
+void write_node(BlockWriter &writer, const Constant<T> &expr) {
+    using Value = std::decay_t<T>;
+    static_assert(std::is_trivially_copyable<Value>::value,
+                  "only constants of trivially copyable types can be serialized");
+    static_assert(alignof(Value) <= serialization::alignment,
+                  "constant's alignment is too large");
+    const Value &value = expr();
+    writer.add({serialization::Kind::constant, 0, 0, 0, 0, sizeof(Value)},
+               &value, alignof(Value));
+}
+
+template<std::size_t N>
+void write_node(BlockWriter &writer, const Variable<N> &expr) {
+    writer.add({serialization::Kind::variable, 0, 0, static_cast<std::uint32_t>(N), 0,
+                static_cast<std::uint32_t>(expr.name().size())},
+               expr.name().data(), 1);
+}
+
+template<template<typename...> typename Op, typename... Nested>
+void write_node(BlockWriter &writer, const Compound<Op, Nested...> &expr) {
+    static_assert(sizeof...(Nested) < 256, "too many operands");
+    writer.add({serialization::Kind::compound, sizeof...(Nested), operation_id<Op>::value,
+                0, 0, 0}, nullptr, 1);
+    std::apply([&writer](const auto &... nested) {
+        auto _ = {0, (write_node(writer, nested), 0)...};
+        static_cast<void>(_);
+    }, expr.get_expressions());
+}
+
+inline const serialization::Record &read_record(const unsigned char *block, std::size_t index) {
+    const auto *header = reinterpret_cast<const serialization::Header *>(block);
+    if (index >= header->node_count) {
+        throw std::invalid_argument("ctaeb: expression has fewer nodes than expected");
+    }
+    return reinterpret_cast<const serialization::Record *>(
+        block + sizeof(serialization::Header))[index];
+}
+
+inline void check_record(bool condition, const char *message) {
+    if (!condition) {
+        throw std::invalid_argument(message);
+    }
+}
+
+template<typename T>
+struct loader;
+
+template<typename T>
+struct loader<Constant<T>> {
+    static Constant<const T &> load(const unsigned char *block, std::size_t index) {
+        const auto &record = read_record(block, index);
+        check_record(record.kind == serialization::Kind::constant && record.size == sizeof(T),
+                     "ctaeb: constant expected");
+        const unsigned char *value = block + record.offset;
+        check_record(reinterpret_cast<std::uintptr_t>(value) % alignof(T) == 0,
+                     "ctaeb: misaligned constant");
+        return Constant<const T &>(*reinterpret_cast<const T *>(value));
+    }
+};
+
+template<std::size_t N>
+struct loader<Variable<N>> {
+    static Variable<N> load(const unsigned char *block, std::size_t index) {
+        const auto &record = read_record(block, index);
+        check_record(record.kind == serialization::Kind::variable && record.index == N,
+                     "ctaeb: variable expected");
+        return Variable<N>(std::string(reinterpret_cast<const char *>(block + record.offset),
+                                       record.size));
+    }
+};
+
+/**
+ * Returns the index of the operand `I` of a compound relative to the index of
+ * the compound itself.
+ */
+template<std::size_t I, typename... Nested>
+constexpr std::size_t operand_offset() {
+    constexpr std::size_t sizes[] = {node_count<Nested>::value..., 0};
+    std::size_t offset = 1;
+    for (std::size_t i = 0; i < I; ++i) {
+        offset += sizes[i];
+    }
+    return offset;
+}
+
+/**
+ * Operands are found at the indices computed from the sizes of the preceding
+ * subtrees, which are known at compile time.
+ */
+template<template<typename...> typename Op, typename... Nested>
+struct loader<Compound<Op, Nested...>> {
+    using type = typename mapped<Compound<Op, Nested...>>::type;
+
+    static type load(const unsigned char *block, std::size_t index) {
+        const auto &record = read_record(block, index);
+        check_record(record.kind == serialization::Kind::compound &&
+                     record.operation == operation_id<Op>::value &&
+                     record.arity == sizeof...(Nested),
+                     "ctaeb: compound expected");
+        return load(block, index, std::index_sequence_for<Nested...>());
+    }
+
+    template<std::size_t... I>
+    static type load(const unsigned char *block, std::size_t index, std::index_sequence<I...>) {
+        return type(loader<Nested>::load(block, index + operand_offset<I, Nested...>())...);
+    }
+};
+
+} //::detail
+
+/**
+ * The type of the expression that `load<E>` returns. It has the structure
+ * of `canonical_t<E>`, but its constants are of the type
+ * `Constant<const T &>` and refer to the values in the loaded block.
+ */
+template<typename E>
+using mapped_t = typename detail::mapped<canonical_t<E>>::type;
+
+/**
+ * Appends the binary representation of `expr` to `out`; see
+ * `serialization`. Constants must be trivially copyable.
+ */
+template<typename E, typename = Expression<E>>
+void serialize(std::vector<unsigned char> &out, const E &expr) {
+    detail::BlockWriter writer(out, detail::node_count<canonical_t<E>>::value);
+    detail::write_node(writer, expr);
+    writer.finish();
+}
+
+/**
+ * Returns the binary representation of `expr`.
+ */
+template<typename E, typename = Expression<E>>
+std::vector<unsigned char> serialize(const E &expr) {
+    std::vector<unsigned char> out;
+    serialize(out, expr);
+    return out;
+}
+
+/**
+ * Returns the size of the block at `data`, which is the offset of the next
+ * block in a file of several ones.
+ */
+inline std::size_t block_size(const void *data) {
+    return reinterpret_cast<const serialization::Header *>(data)->size;
+}
+
+/**
+ * Makes an expression from the block at `data`, which must be aligned to 16
+ * bytes, such as the beginning of a memory-mapped file. The expression must
+ * have been written by `serialize` from an expression of the type `E` (up
+ * to `canonical_t`) in a program built by the same compiler for the same
+ * platform; the structure is checked, and @em std::invalid_argument is thrown
+ * on mismatch. Constants of the result refer to the values in the block,
+ * which must outlive it; nothing is parsed or copied except for variable
+ * names.
+ * @code
+ * using Invariant = decltype(Variable<2>() == Variable<1>() + 1);
+ * auto invariant = load<Invariant>(mapped_file);
+ * invariant(1, 2);
+ * @endcode
+ */
+template<typename E>
+mapped_t<E> load(const void *data) {
+    const auto *block = static_cast<const unsigned char *>(data);
+    const auto *header = reinterpret_cast<const serialization::Header *>(block);
+    if (header->magic != serialization::magic || header->version != serialization::version) {
+        throw std::invalid_argument("ctaeb: not a serialized expression");
+    }
+    if (header->node_count != detail::node_count<canonical_t<E>>::value) {
+        throw std::invalid_argument("ctaeb: unexpected number of nodes");
+    }
+    return detail::loader<canonical_t<E>>::load(block, 0);
+}
+
+} //::ctaeb
+
+#endif //CTAEB_SERIALIZE_H
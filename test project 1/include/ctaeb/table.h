@@ -0,0 +1,362 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Defines `Table`, a flat representation of expressions that are too
+ * large to be nested `Compound` objects.
+ */
+
+#ifndef CTAEB_TABLE_H
+#define CTAEB_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expression.h"
+
+namespace ctaeb {
+
+/**
+ * An operation node of a `Table`. Applies `Op` to the values of the table
+ * nodes with indices `I...`, in the same way as `Compound<Op, ...>` applies
+ * it to its nested expressions. Nodes carry no state.
+ */
+template <template <typename...> typename Op, std::size_t... I>
+struct Node {
+};
+
+template<typename... Nodes>
+class Table;
+
+namespace detail {
+
+template<typename T>
+struct is_node : std::false_type {
+};
+
+template<template<typename...> typename Op, std::size_t... I>
+struct is_node<Node<Op, I...>> : std::true_type {
+};
+
+/**
+ * Holds the table node with index `I`. `Table` inherits from one slot per
+ * node; the base class list is flat, so adding a node doesn't make the
+ * existing ones any deeper.
+ */
+template<std::size_t I, typename T>
+struct TableSlot {
+    T node;
+};
+
+template<std::size_t I, template<typename...> typename Op, std::size_t... Operands>
+struct TableSlot<I, Node<Op, Operands...>> {
+    static_assert(((Operands < I) && ...),
+                  "ctaeb::Node: an operand index must refer to one of the preceding nodes");
+
+    Node<Op, Operands...> node;
+};
+
+template<typename, typename...>
+struct TableStorage;
+
+template<std::size_t... I, typename... Nodes>
+struct TableStorage<std::index_sequence<I...>, Nodes...>
+    : TableSlot<I, Nodes>... {
+};
+
+/**
+ * Selects the slot with the index `I`; the node type is deduced from the
+ * matching base class.
+ */
+template<std::size_t I, typename T>
+const T &table_node(const TableSlot<I, T> &slot) {
+    return slot.node;
+}
+
+template<std::size_t, typename T>
+using indexed_t = T;
+
+template<typename T>
+struct type_tag {
+    using type = T;
+};
+
+/**
+ * Combines two value types in a fold expression; a fold, unlike
+ * `std::common_type` of many types, doesn't nest instantiations.
+ */
+template<typename T1, typename T2>
+type_tag<std::common_type_t<T1, T2>> operator|(type_tag<T1>, type_tag<T2>);
+
+template<typename... Ts>
+struct fold_common_type {
+    using type = typename decltype((type_tag<Ts>() | ...))::type;
+};
+
+template<typename... Ts>
+using fold_common_type_t = typename fold_common_type<Ts...>::type;
+
+/**
+ * Stands for an operand of the type `R` when the result type of a node
+ * is computed.
+ */
+template<typename R>
+struct TableOperand {
+    template<typename... Args>
+    R operator()(Args &...) const;
+};
+
+/**
+ * The value type that the node `N` adds to the intermediate results of
+ * a table: the value of a constant, the result of an expression, or
+ * the result of an operation node applied to operands of the type `R`.
+ */
+template<typename N, typename R, typename... Args>
+struct table_node_type {
+    using type = std::decay_t<decltype(std::declval<const N &>()(std::declval<Args &>()...))>;
+};
+
+template<typename T, typename R, typename... Args>
+struct table_node_type<Constant<T>, R, Args...> {
+    using type = std::decay_t<T>;
+};
+
+template<std::size_t N, typename R, typename... Args>
+struct table_node_type<Variable<N>, R, Args...> {
+    using type = R;
+};
+
+template<template<typename...> typename Op, std::size_t... I, typename R, typename... Args>
+struct table_node_type<Node<Op, I...>, R, Args...> {
+    using type = std::decay_t<decltype(std::declval<Invoker<Op>>()(
+        std::declval<std::tuple<indexed_t<I, TableOperand<R>>...>>(), std::declval<Args &>()...))>;
+};
+
+/**
+ * Same as `table_node_type`, but doesn't add anything to `R` for the nodes
+ * that don't fit the condition `Use`, which aren't instantiated.
+ */
+template<bool Use, typename N, typename R, typename... Args>
+struct table_node_type_if {
+    using type = R;
+};
+
+template<typename N, typename R, typename... Args>
+struct table_node_type_if<true, N, R, Args...> : table_node_type<N, R, Args...> {
+};
+
+/**
+ * The type of the intermediate results of a table evaluated with
+ * the arguments `Args`: the common type of the arguments and the values of
+ * the constants and expressions, combined with the result types of
+ * the operation nodes other than the root.
+ */
+template<typename T, typename... Args>
+struct table_value_type;
+
+template<typename... Nodes, typename... Args>
+struct table_value_type<Table<Nodes...>, Args...> {
+    using Inputs = fold_common_type_t<std::decay_t<Args>...>;
+    using Leaves = fold_common_type_t<Inputs,
+        typename table_node_type_if<!is_node<Nodes>::value, Nodes, Inputs, Args...>::type...>;
+
+    template<std::size_t... I>
+    static auto combine(std::index_sequence<I...>) -> fold_common_type_t<Leaves,
+        typename table_node_type_if<is_node<Nodes>::value && I + 1 < sizeof...(Nodes),
+                                    Nodes, Leaves, Args...>::type...>;
+
+    using type = decltype(combine(std::index_sequence_for<Nodes...>()));
+};
+
+template<typename T, typename R, typename... Args>
+using TableEvaluator = R (*)(const T &, Args &...);
+
+template<typename T, typename R, typename... Args>
+struct table_evaluators;
+
+/**
+ * A reference to a table node that looks like an ordinary expression to
+ * `Invoker`. The index is a data member rather than a template parameter,
+ * thus all operation nodes of the same arity share the same `Invoker`
+ * instantiation.
+ */
+template<typename T, typename R>
+struct TableRef {
+    const T &table;
+    std::size_t index;
+
+    template<typename... Args>
+    R operator()(Args &... args) const {
+        return detail::table_evaluators<T, R, Args...>::value[index](table, args...);
+    }
+};
+
+template<typename R, typename T, template<typename...> typename Op,
+         std::size_t... I, typename... Args>
+decltype(auto) table_apply(const T &table, const Node<Op, I...> &, Args &... args) {
+    Invoker<Op> invoker;
+    return invoker(std::tuple<indexed_t<I, TableRef<T, R>>...>(
+        TableRef<T, R>{table, I}...), args...);
+}
+
+template<typename R, typename T, typename E, typename... Args>
+decltype(auto) table_apply(const T &, const E &expr, Args &... args) {
+    return expr(args...);
+}
+
+/**
+ * Evaluates the node `I` of the type `Node` and converts the result to `R`.
+ * These functions are templates of the table type rather than members of
+ * `Table`, which keeps their template argument lists short no matter how
+ * many nodes the table has.
+ */
+template<typename T, std::size_t I, typename Node, typename R, typename... Args>
+R table_value(const T &table, Args &... args) {
+    const auto &slot = static_cast<const TableSlot<I, Node> &>(table);
+    return static_cast<R>(detail::table_apply<R>(table, slot.node, args...));
+}
+
+/**
+ * The evaluator of the node `I`. The root is not an operand of any node
+ * and is evaluated by `Table::eval` itself, with its own result type,
+ * which may not be convertible to `R`; it gets no evaluator.
+ */
+template<bool Root, typename T, std::size_t I, typename Node, typename R, typename... Args>
+struct table_evaluator {
+    static constexpr TableEvaluator<T, R, Args...> value = &table_value<T, I, Node, R, Args...>;
+};
+
+template<typename T, std::size_t I, typename Node, typename R, typename... Args>
+struct table_evaluator<true, T, I, Node, R, Args...> {
+    static constexpr TableEvaluator<T, R, Args...> value = nullptr;
+};
+
+/**
+ * The table type is a separate parameter `T`, rather than `Table<Nodes...>`
+ * spelled in the pack expansion below, which would build the list of all
+ * the nodes again for each node.
+ */
+template<typename T, typename R, typename... Args, typename... Nodes, std::size_t... I>
+constexpr auto make_table_evaluators(const TableStorage<std::index_sequence<I...>, Nodes...> *) {
+    constexpr std::size_t root = sizeof...(Nodes) - 1;
+    return std::array<TableEvaluator<T, R, Args...>, sizeof...(I)>{
+        {table_evaluator<I == root, T, I, Nodes, R, Args...>::value...}
+    };
+}
+
+/**
+ * Evaluators of all the nodes of a table. A parent node calls its operands
+ * through this array instead of naming their evaluators directly, so none
+ * of them is instantiated from another one, and the instantiation depth
+ * doesn't grow with the size of the table. The indices are constant,
+ * therefore an optimizing compiler still turns these into direct calls.
+ */
+template<typename... Nodes, typename R, typename... Args>
+struct table_evaluators<Table<Nodes...>, R, Args...> {
+    static constexpr auto value = detail::make_table_evaluators<Table<Nodes...>, R, Args...>(
+        static_cast<const Table<Nodes...> *>(nullptr));
+};
+
+} //::detail
+
+/**
+ * Flat representation of an expression: a list of nodes addressed by their
+ * indices. A node is either an expression (`Constant`, `Variable`, or even
+ * a `Compound`), or a `Node<Op, I...>` that applies `Op` to the nodes `I...`.
+ * The last node is the root of the expression. A table is an aggregate;
+ * operation nodes have no state and are initialized with `{}`. For example,
+ * `(x + 1) * x` is written as
+ * @code
+ * Table<Variable<1>,            // 0: x
+ *       Constant<int>,          // 1: 1
+ *       Node<std::plus, 0, 1>,  // 2: x + 1
+ *       Node<std::multiplies, 2, 0>> t{x, 1, {}, {}};
+ * @endcode
+ * `Table` is meant for generated expressions with thousands of nodes. Every
+ * `Compound` nests the types of its sub-expressions, so a chain of `n`
+ * operations takes `n` nested template instantiations to build and evaluate,
+ * which quickly hits the compiler's template depth limit. Nodes of a table
+ * are instantiated one by one; the instantiation depth doesn't grow with
+ * the number of nodes, and the result of a node referenced several times
+ * may be shared by listing it once.
+ *
+ * Evaluation uses the same `detail::Invoker` as `Compound`, thus
+ * @em std::logical_and and @em std::logical_or nodes are short-circuited as
+ * usual. The price for the flat structure is that the intermediate results
+ * are converted to a single value type: `std::common_type` of the input
+ * values, the values of the constants, and the results of the operation
+ * nodes other than the root (or the type given explicitly via `eval<R>()`).
+ * For `int` inputs, a `double` constant makes it `double`; a comparison of
+ * two `double` values then yields 0.0 or 1.0. The root node returns
+ * the value of its operation as is, thus a table of strings may end with
+ * a comparison, but an intermediate comparison of strings doesn't compile,
+ * since @em bool and @em std::string have no common type.
+ *
+ * Operation nodes refer to the preceding nodes only. The template argument
+ * lists of the per-node functions don't repeat the list of the nodes, so
+ * the compilation time and memory grow linearly with the size of a table.
+ */
+template<typename... Nodes>
+class Table
+    : public detail::TableStorage<std::index_sequence_for<Nodes...>, Nodes...> {
+    static constexpr std::size_t root = sizeof...(Nodes) - 1;
+
+  public:
+    /**
+     * Returns the node with the index `I`.
+     */
+    template<std::size_t I>
+    const auto &get() const {
+        return detail::table_node<I>(*this);
+    }
+
+    /**
+     * Evaluates the expression; see `Table` for the type of the intermediate
+     * results.
+     */
+    template<typename T, typename... Args>
+    decltype(auto) operator()(T &&arg, Args &&... args) const {
+        using R = typename detail::table_value_type<Table, T, Args...>::type;
+        return eval<R>(std::forward<T>(arg), std::forward<Args>(args)...);
+    }
+
+    /**
+     * Same as `operator()`, with the arguments given as a tuple; see
+     * `Compound::apply`.
+     */
+    template<typename Tuple>
+    decltype(auto) apply(Tuple &&args) const {
+        return detail::apply_tuple(*this, args);
+    }
+
+    /**
+     * Evaluates the expression; intermediate results are converted to `R`.
+     */
+    template<typename R, typename... Args>
+    decltype(auto) eval(Args &&... args) const {
+        return detail::table_apply<R>(*this, get<root>(), args...);
+    }
+};
+
+namespace detail {
+
+template<typename... Nodes>
+struct is_table<ctaeb::Table<Nodes...>> : std::true_type {
+};
+
+#if CTAEB_HAS_CONCEPTS
+template<typename... Nodes>
+inline constexpr bool is_expression_v<ctaeb::Table<Nodes...>> = true;
+#endif
+
+} //::detail
+
+} //::ctaeb
+
+#endif //CTAEB_TABLE_H
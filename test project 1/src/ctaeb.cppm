@@ -0,0 +1,167 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Interface unit of the `ctaeb` named module. Importing the module
+ * gives the same API as including `ctaeb.h`, but the library headers and
+ * the standard headers they depend on are parsed once, when the module is
+ * built, instead of once per translation unit.
+ *
+ * The headers remain the primary form of the library; the module re-exports
+ * their declarations, so both may be used in the same program.
+ */
+
+module;
+
+#include <ctaeb/ctaeb.h>
+
+export module ctaeb;
+
+export namespace ctaeb {
+
+// expressions
+using ctaeb::Constant;
+using ctaeb::Variable;
+using ctaeb::Compound;
+using ctaeb::Table;
+using ctaeb::Node;
+using ctaeb::Evaluation;
+using ctaeb::evaluate;
+using ctaeb::BoundFunction;
+using ctaeb::to_function_pointer;
+using ctaeb::canonical_t;
+using ctaeb::canonical;
+using ctaeb::normalized_t;
+using ctaeb::normalize;
+using ctaeb::Placeholder;
+using ctaeb::Rule;
+using ctaeb::rewrite_rules;
+using ctaeb::rewritten_t;
+using ctaeb::rewrite;
+using ctaeb::optimized_t;
+using ctaeb::optimize;
+using ctaeb::in_range;
+using ctaeb::in_closed_range;
+using ctaeb::one_of;
+using ctaeb::ValueSet;
+using ctaeb::is_commutative;
+using ctaeb::is_pure_operation;
+using ctaeb::is_lazy_operation;
+using ctaeb::Adaptive;
+using ctaeb::adaptive;
+using ctaeb::filter;
+using ctaeb::filter_bitmap;
+using ctaeb::operation_id;
+using ctaeb::mapped_t;
+using ctaeb::serialize;
+using ctaeb::load;
+using ctaeb::block_size;
+using ctaeb::structure_hash_v;
+using ctaeb::hash;
+using ctaeb::structurally_equal;
+using ctaeb::ExpressionHash;
+using ctaeb::StructurallyEqual;
+using ctaeb::Context;
+using ctaeb::Local;
+using ctaeb::Bind;
+using ctaeb::Let;
+using ctaeb::let;
+using ctaeb::if_then_else;
+using ctaeb::branchless_select;
+using ctaeb::select;
+using ctaeb::blend;
+using ctaeb::square_root;
+using ctaeb::exponential;
+using ctaeb::logarithm;
+using ctaeb::power;
+using ctaeb::absolute;
+using ctaeb::minimum;
+using ctaeb::maximum;
+using ctaeb::sqrt;
+using ctaeb::exp;
+using ctaeb::log;
+using ctaeb::pow;
+using ctaeb::abs;
+using ctaeb::min;
+using ctaeb::max;
+using ctaeb::cost;
+using ctaeb::expression_cost;
+using ctaeb::expression_cost_v;
+using ctaeb::TaskGroup;
+using ctaeb::ThreadPool;
+using ctaeb::Parallel;
+using ctaeb::parallel;
+namespace serialization {
+using ctaeb::serialization::Header;
+using ctaeb::serialization::Record;
+using ctaeb::serialization::Kind;
+using ctaeb::serialization::magic;
+using ctaeb::serialization::version;
+using ctaeb::serialization::alignment;
+} //::serialization
+
+// SFINAE helpers for user-defined operators
+using ctaeb::Expression;
+using ctaeb::NonExpression;
+using ctaeb::Expressions;
+using ctaeb::AnyExpression;
+
+#if CTAEB_HAS_CONCEPTS
+using ctaeb::expression;
+using ctaeb::expression_operands;
+#endif
+
+// operations.h
+using ctaeb::operator+;
+using ctaeb::operator-;
+using ctaeb::operator*;
+using ctaeb::operator/;
+using ctaeb::operator==;
+using ctaeb::operator!=;
+using ctaeb::operator<;
+using ctaeb::operator<=;
+using ctaeb::operator>;
+using ctaeb::operator>=;
+using ctaeb::operator&&;
+using ctaeb::operator||;
+using ctaeb::operator!;
+using ctaeb::operator%;
+using ctaeb::operator&;
+using ctaeb::operator|;
+using ctaeb::operator^;
+using ctaeb::operator>>;
+using ctaeb::operator~;
+using ctaeb::shift_left;
+using ctaeb::shift_right;
+
+// print.h
+using ctaeb::operator<<;
+using ctaeb::to_string;
+
+namespace print {
+using ctaeb::print::to_string;
+using ctaeb::print::prefixed;
+} //::print
+
+#if CTAEB_HAS_NAMED_ARGUMENTS
+using ctaeb::Arg;
+using ctaeb::ArgKey;
+using ctaeb::arg;
+using ctaeb::Named;
+using ctaeb::named;
+#endif
+
+#ifdef CTAEB_INSTRUMENTATION
+namespace instrumentation {
+using ctaeb::instrumentation::Totals;
+using ctaeb::instrumentation::Counters;
+using ctaeb::instrumentation::counters;
+using ctaeb::instrumentation::report;
+using ctaeb::instrumentation::reset;
+} //::instrumentation
+#endif
+
+} //::ctaeb
@@ -0,0 +1,10 @@
+// Copyright (c) 2018 Igor Chalenko
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt
+
+/**
+ * @file
+ * @brief Translation unit that produces the precompiled `ctaeb.h` for the
+ * `ctaeb.pch` target. The header itself is injected by cmake.
+ */